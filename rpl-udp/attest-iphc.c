@@ -0,0 +1,175 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Implementation of the classifier of the compressed 6LoWPAN frames. See attest-iphc.h for the
+// description of the functionality.
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------- Imports of the libraries -------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+#include "attest-iphc.h"
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Initialize ----------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Initialize the dispatch values (RFC 4944 and RFC 6282)
+#define DISPATCH_FRAG1      0xc0  // 11000xxx, first fragment, 4 bytes
+#define DISPATCH_FRAG_MASK  0xf8
+#define DISPATCH_IPHC       0x60  // 011xxxxx
+#define DISPATCH_IPHC_MASK  0xe0
+#define NHC_EXT             0xe0  // 1110EEEN, extension header
+#define NHC_EXT_MASK        0xf0
+#define NHC_EXT_IPV6        0x0e  // EEE = 7, encapsulated IPv6 header
+#define NHC_UDP             0xf0  // 11110CPP, UDP header
+#define NHC_UDP_MASK        0xf8
+#define PROTO_UDP           17
+
+// Initialize the inline lengths of the traffic class and flow label (TF) and of the addresses,
+// indexed by the 2 bits of the mode
+static const uint8_t tf_len[4] = { 4, 3, 1, 0 };
+static const uint8_t addr_len[4] = { 16, 8, 2, 0 };              // stateless
+static const uint8_t addr_ctx_len[4] = { 0, 8, 2, 0 };           // context based
+static const uint8_t mcast_len[4] = { 16, 6, 4, 1 };             // multicast, stateless
+static const uint8_t mcast_ctx_len[4] = { 6, 0, 0, 0 };          // multicast, context based
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- Functions ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Returns a 16 bit value in network byte order
+static uint16_t
+get16(const uint8_t *p)
+{
+  return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+// Read the ports of a UDP header compressed with NHC at frame[p]
+static bool
+nhc_udp_ports(const uint8_t *frame, uint16_t len, uint16_t p, uint16_t *src_port,
+              uint16_t *dst_port)
+{
+  uint8_t ports = frame[p++] & 0x03;
+  switch(ports) {
+  case 0:
+    // Both ports inline
+    if(p + 4 > len) {
+      return false;
+    }
+    *src_port = get16(frame + p);
+    *dst_port = get16(frame + p + 2);
+    return true;
+  case 1:
+    // Source port inline, the last 8 bits of the destination port
+    if(p + 3 > len) {
+      return false;
+    }
+    *src_port = get16(frame + p);
+    *dst_port = 0xf000 | frame[p + 2];
+    return true;
+  case 2:
+    // The last 8 bits of the source port, destination port inline
+    if(p + 3 > len) {
+      return false;
+    }
+    *src_port = 0xf000 | frame[p];
+    *dst_port = get16(frame + p + 1);
+    return true;
+  default:
+    // The last 4 bits of both ports
+    if(p + 1 > len) {
+      return false;
+    }
+    *src_port = 0xf0b0 | (frame[p] >> 4);
+    *dst_port = 0xf0b0 | (frame[p] & 0x0f);
+    return true;
+  }
+}
+
+bool
+attest_iphc_udp_ports(const uint8_t *frame, uint16_t len, uint16_t *src_port,
+                      uint16_t *dst_port)
+{
+  uint32_t p = 0;
+  uint8_t iphc0, iphc1;
+  uint8_t next_header = 0;
+  bool nhc;
+
+  if(frame == NULL) {
+    return false;
+  }
+
+  // The first fragment has its own header before the IPHC header
+  if(len >= 4 && (frame[0] & DISPATCH_FRAG_MASK) == DISPATCH_FRAG1) {
+    p = 4;
+  }
+  if(p + 2 > len || (frame[p] & DISPATCH_IPHC_MASK) != DISPATCH_IPHC) {
+    return false;
+  }
+  iphc0 = frame[p];
+  iphc1 = frame[p + 1];
+  p += 2;
+
+  // The inline fields follow in this order: context identifiers, traffic class and flow label,
+  // next header, hop limit, source address and destination address
+  if(iphc1 & 0x80) {
+    p++;
+  }
+  p += tf_len[(iphc0 >> 3) & 0x03];
+  nhc = (iphc0 & 0x04) != 0;
+  if(!nhc) {
+    if(p + 1 > len) {
+      return false;
+    }
+    next_header = frame[p++];
+  }
+  if((iphc0 & 0x03) == 0) {
+    p++;
+  }
+  p += (iphc1 & 0x40) ? addr_ctx_len[(iphc1 >> 4) & 0x03] : addr_len[(iphc1 >> 4) & 0x03];
+  if(iphc1 & 0x08) {
+    p += (iphc1 & 0x04) ? mcast_ctx_len[iphc1 & 0x03] : mcast_len[iphc1 & 0x03];
+  }
+  else {
+    p += (iphc1 & 0x04) ? addr_ctx_len[iphc1 & 0x03] : addr_len[iphc1 & 0x03];
+  }
+
+  // The extension headers compressed with NHC: <NHC> [next header] <length> <length bytes>. The
+  // next header is inline when the N bit is not set, it is then not compressed
+  while(nhc) {
+    if(p + 1 > len) {
+      return false;
+    }
+    if((frame[p] & NHC_UDP_MASK) == NHC_UDP) {
+      return nhc_udp_ports(frame, len, (uint16_t)p, src_port, dst_port);
+    }
+    if((frame[p] & NHC_EXT_MASK) != NHC_EXT || (frame[p] & 0x0e) == NHC_EXT_IPV6) {
+      return false;
+    }
+    nhc = (frame[p] & 0x01) != 0;
+    p++;
+    if(!nhc) {
+      if(p + 1 > len) {
+        return false;
+      }
+      next_header = frame[p++];
+    }
+    if(p + 1 > len) {
+      return false;
+    }
+    p += 1 + frame[p];
+  }
+
+  // A UDP header that is not compressed, the ports are its first 4 bytes
+  if(next_header != PROTO_UDP || p + 4 > len) {
+    return false;
+  }
+  *src_port = get16(frame + p);
+  *dst_port = get16(frame + p + 2);
+  return true;
+}
+/*------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,37 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Classifier of the compressed 6LoWPAN frames (RFC 6282). It walks the IPHC header, the extension
+// headers compressed with NHC (e.g. the RPL hop-by-hop option and source routing header) and the
+// UDP header, compressed with NHC or inline, and returns the UDP ports of the frame. It is used by
+// the TSCH scheduler (orchestra-attest.c) to find the attestation packets in the MAC layer, where
+// only the compressed frame is available.
+//
+// The first fragment of a fragmented packet is classified, the following fragments carry no
+// header and are not. Like attest-msg.c the module does not depend on Contiki so that it can be
+// tested natively (native/), every length is checked against the frame.
+
+#ifndef ATTEST_IPHC_H_
+#define ATTEST_IPHC_H_
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------- Imports of the libraries -------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- Functions ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Find the UDP ports of a compressed frame. Returns true and the ports if the frame is the first
+// fragment or the whole of a UDP packet, false otherwise
+bool attest_iphc_udp_ports(const uint8_t *frame, uint16_t len, uint16_t *src_port,
+                           uint16_t *dst_port);
+
+#endif /* ATTEST_IPHC_H_ */
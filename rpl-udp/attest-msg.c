@@ -0,0 +1,255 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Implementation of the parser of the attestation messages. See attest-msg.h for the description of
+// the messages.
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------- Imports of the libraries -------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+#include "attest-msg.h"
+#include <string.h>
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- Functions ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Returns the type of an item, the items are compared by length first so that most of the words
+// are rejected without a memcmp
+static uint8_t
+item_type(const char *item, uint16_t len)
+{
+  switch(len) {
+  case 3:
+    if(memcmp(item, "ack", 3) == 0) {
+      return ATTEST_MSG_ACK;
+    }
+    break;
+  case 5:
+    if(memcmp(item, "hello", 5) == 0) {
+      return ATTEST_MSG_HELLO;
+    }
+    if(memcmp(item, "moved", 5) == 0) {
+      return ATTEST_MSG_MOVED;
+    }
+    break;
+  case 6:
+    if(memcmp(item, "attest", 6) == 0) {
+      return ATTEST_MSG_ATTEST;
+    }
+    break;
+  case 8:
+    if(memcmp(item, "validate", 8) == 0) {
+      return ATTEST_MSG_VALIDATE;
+    }
+    break;
+  }
+  return ATTEST_MSG_UNKNOWN;
+}
+
+// Returns true if the item is a decimal number
+static bool
+item_is_number(const char *item, uint16_t len)
+{
+  uint16_t i;
+  for(i = 0; i < len; i++) {
+    if(item[i] < '0' || item[i] > '9') {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the value of a decimal item, saturated to 16 bits
+static uint16_t
+item_number(const char *item, uint16_t len)
+{
+  uint32_t value = 0;
+  uint16_t i;
+  for(i = 0; i < len; i++) {
+    if(item[i] < '0' || item[i] > '9') {
+      return 0;
+    }
+    value = value * 10 + (uint32_t)(item[i] - '0');
+    if(value > 0xffff) {
+      return 0xffff;
+    }
+  }
+  return (uint16_t)value;
+}
+
+int
+attest_msg_parse(const uint8_t *data, uint16_t datalen, struct attest_msg *msg)
+{
+  const char *p = (const char *)data;
+  uint16_t i = 0;
+  uint16_t start;
+  bool want_mask = false;
+
+  memset(msg, 0, sizeof(*msg));
+  if(data == NULL || datalen == 0) {
+    return ATTEST_MSG_EMPTY;
+  }
+  if(datalen > ATTEST_MSG_MAX) {
+    return ATTEST_MSG_TOO_LONG;
+  }
+
+  // The key is the first word, it has to fit in the key arrays with the terminating zero
+  while(i < datalen && p[i] != ' ') {
+    if(p[i] < 0x21 || p[i] > 0x7e) {
+      return ATTEST_MSG_BAD_CHAR;
+    }
+    i++;
+  }
+  if(i == 0 || i >= ATTEST_KEY_SIZE) {
+    return ATTEST_MSG_BAD_KEY;
+  }
+  msg->key = p;
+  msg->key_len = (uint8_t)i;
+
+  // The body starts after the space that follows the key
+  if(i < datalen) {
+    i++;
+  }
+  msg->body = p + i;
+  msg->body_len = datalen - i;
+
+  // The items of the body, one pass over the remaining bytes
+  while(i < datalen) {
+    if(p[i] == ' ') {
+      i++;
+      continue;
+    }
+    start = i;
+    while(i < datalen && p[i] != ' ') {
+      if(p[i] < 0x21 || p[i] > 0x7e) {
+        return ATTEST_MSG_BAD_CHAR;
+      }
+      i++;
+    }
+
+    if(want_mask) {
+      msg->moved_mask = item_number(p + start, i - start);
+      want_mask = false;
+    }
+    else if(!(msg->items & ATTEST_ITEM_SEQ) && item_is_number(p + start, i - start)) {
+      msg->seq = item_number(p + start, i - start);
+      msg->items |= ATTEST_ITEM_SEQ;
+    }
+    else {
+      uint8_t type = item_type(p + start, i - start);
+      if(msg->first == NULL) {
+        msg->first = p + start;
+        msg->first_len = (uint8_t)(i - start);
+        msg->type = type;
+      }
+      if(type == ATTEST_MSG_VALIDATE) {
+        msg->items |= ATTEST_ITEM_VALIDATE;
+      }
+      else if(type == ATTEST_MSG_ATTEST) {
+        msg->items |= ATTEST_ITEM_ATTEST;
+      }
+      else if(type == ATTEST_MSG_MOVED) {
+        msg->items |= ATTEST_ITEM_MOVED;
+        want_mask = true;
+      }
+    }
+  }
+  return ATTEST_MSG_OK;
+}
+
+bool
+attest_msg_key_equals(const struct attest_msg *msg, const char *key)
+{
+  return strncmp(key, msg->key, msg->key_len) == 0 && key[msg->key_len] == '\0';
+}
+
+void
+attest_msg_copy_key(const struct attest_msg *msg, char *key)
+{
+  memcpy(key, msg->key, msg->key_len);
+  key[msg->key_len] = '\0';
+}
+
+// Write a decimal number, returns its number of digits
+static uint16_t
+put_number(uint8_t *buf, uint16_t value)
+{
+  uint8_t digits[5];
+  uint16_t n = 0, i;
+  do {
+    digits[n++] = '0' + value % 10;
+    value /= 10;
+  } while(value != 0);
+  for(i = 0; i < n; i++) {
+    buf[i] = digits[n - 1 - i];
+  }
+  return n;
+}
+
+uint16_t
+attest_msg_build_reply(uint8_t *buf, uint16_t size, const char *key,
+                       const struct attest_msg *msg, uint8_t mode, bool validate)
+{
+  uint16_t key_len = strlen(key);
+  uint16_t len = key_len + 1;
+
+  // The longest reply: the key, the body or "ack 65535", and " validate"
+  if(mode == ATTEST_REPLY_NONE && !validate) {
+    return 0;
+  }
+  if((uint32_t)len + (mode == ATTEST_REPLY_ECHO ? msg->body_len : 9) + 9 > size) {
+    return 0;
+  }
+
+  // The body is moved first, it can be in buf after the key of the sender. memmove does nothing
+  // when the keys have the same length and the body is already in place
+  if(mode == ATTEST_REPLY_ECHO) {
+    if(buf + len != (const uint8_t *)msg->body) {
+      memmove(buf + len, msg->body, msg->body_len);
+    }
+    len += msg->body_len;
+  }
+  else if(mode == ATTEST_REPLY_ACK) {
+    memcpy(buf + len, "ack", 3);
+    len += 3;
+    if(msg->items & ATTEST_ITEM_SEQ) {
+      buf[len++] = ' ';
+      len += put_number(buf + len, msg->seq);
+    }
+  }
+  memcpy(buf, key, key_len);
+  buf[key_len] = ' ';
+
+  if(validate) {
+    if(len > key_len + 1) {
+      buf[len++] = ' ';
+    }
+    memcpy(buf + len, "validate", 8);
+    len += 8;
+  }
+  return len;
+}
+
+const char *
+attest_msg_error(int result)
+{
+  switch(result) {
+  case ATTEST_MSG_OK:
+    return "ok";
+  case ATTEST_MSG_EMPTY:
+    return "empty";
+  case ATTEST_MSG_TOO_LONG:
+    return "too long";
+  case ATTEST_MSG_BAD_KEY:
+    return "bad key";
+  case ATTEST_MSG_BAD_CHAR:
+    return "bad character";
+  }
+  return "unknown";
+}
+/*------------------------------------------------------------------------------------------------*/
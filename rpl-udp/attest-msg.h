@@ -0,0 +1,115 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Parser of the attestation messages. A message is a line of printable ASCII words separated by
+// single or multiple spaces: "<key> <item> [<item> ...]", for example
+//   "abcdefghij hello 12"            periodic message of a client
+//   "abcdefghij hello 12 attest"     periodic message with the piggybacked response
+//   "abcdefghij hello 12 validate"   echo reply with the piggybacked request to validate
+//   "abcdefghij ack 12"              short reply with the sequence number of the hello only
+//   "abcdefghij validate "           request to validate
+//   "abcdefghij attest"              response to the request to validate
+//   "abcdefghij moved 5"             redirection to another server with the live servers mask
+//
+// The parser works on the received buffer in place and does not copy or modify it. It checks the
+// length of the message and of the key, so the callers never have to copy the data into fixed
+// size arrays. The module does not depend on Contiki so that it can be tested natively (native/).
+//
+// The reply of the server to a hello is built by attest_msg_build_reply directly in the outgoing
+// buffer, without a temporary array. simple-udp has already copied the received payload into its
+// own buffer, so the echoed body is copied once from there on every reply. The reply depends on
+// ATTEST_CONF_REPLY_MODE (project-conf.h):
+//   ATTEST_REPLY_ECHO   "<server key> <received body>"   the default, the full hello is echoed
+//   ATTEST_REPLY_ACK    "<server key> ack <seq>"          only the sequence number of the hello
+//   ATTEST_REPLY_NONE   no reply at all, except "<server key> validate" to carry a piggybacked
+//                       request to validate
+// In all the modes a pending request to validate is added at the end (" validate").
+
+#ifndef ATTEST_MSG_H_
+#define ATTEST_MSG_H_
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------- Imports of the libraries -------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Initialize ----------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Initialize the size of the key arrays (with the terminating zero) and the maximum message length
+#define ATTEST_KEY_SIZE 20
+#define ATTEST_MSG_MAX  120
+
+// Initialize the type of a message, it is given by the first item after the key
+#define ATTEST_MSG_UNKNOWN  0
+#define ATTEST_MSG_HELLO    1
+#define ATTEST_MSG_VALIDATE 2
+#define ATTEST_MSG_ATTEST   3
+#define ATTEST_MSG_MOVED    4
+#define ATTEST_MSG_ACK      5
+
+// Initialize the flags of the items found anywhere in the message
+#define ATTEST_ITEM_VALIDATE 0x01
+#define ATTEST_ITEM_ATTEST   0x02
+#define ATTEST_ITEM_MOVED    0x04
+#define ATTEST_ITEM_SEQ      0x08
+
+// Initialize the result of the parser
+#define ATTEST_MSG_OK          0
+#define ATTEST_MSG_EMPTY      -1
+#define ATTEST_MSG_TOO_LONG   -2
+#define ATTEST_MSG_BAD_KEY    -3
+#define ATTEST_MSG_BAD_CHAR   -4
+
+// Initialize the modes of the reply of the server to a hello
+#define ATTEST_REPLY_ECHO 0
+#define ATTEST_REPLY_ACK  1
+#define ATTEST_REPLY_NONE 2
+
+// A parsed message. All the pointers point into the received buffer, they are not terminated
+struct attest_msg {
+  const char *key;         // key of the sender
+  uint8_t key_len;
+  const char *body;        // everything after the key and its space, echoed by the server
+  uint16_t body_len;
+  const char *first;       // first item after the key, it gives the type of the message
+  uint8_t first_len;
+  uint8_t type;            // ATTEST_MSG_*
+  uint8_t items;           // ATTEST_ITEM_* found in the message
+  uint16_t moved_mask;     // live servers mask of a "moved" message
+  uint16_t seq;            // first decimal item, the sequence number of a hello or an ack
+};
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- Functions ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Parse a received message. Returns ATTEST_MSG_OK or a negative ATTEST_MSG_* error, in that case
+// the message has to be dropped
+int attest_msg_parse(const uint8_t *data, uint16_t datalen, struct attest_msg *msg);
+
+// Returns true if the key of the message is the same as the given zero terminated key
+bool attest_msg_key_equals(const struct attest_msg *msg, const char *key);
+
+// Copy the key of the message into an array of ATTEST_KEY_SIZE bytes and terminate it
+void attest_msg_copy_key(const struct attest_msg *msg, char *key);
+
+// Build the reply of the server to a received message into buf: the key of the server, then the
+// body, the ack or nothing depending on the mode (ATTEST_REPLY_*) and " validate" if validate is
+// set. The body of the message can be in buf itself, e.g. when buf is the outgoing packet buffer
+// and the message the received packet: it is moved before the key is written. Returns the length
+// of the reply, or 0 if there is no reply to send or it does not fit in size bytes.
+uint16_t attest_msg_build_reply(uint8_t *buf, uint16_t size, const char *key,
+                                const struct attest_msg *msg, uint8_t mode, bool validate);
+
+// Returns a short name of the error of the parser, for the logs
+const char *attest_msg_error(int result);
+
+#endif /* ATTEST_MSG_H_ */
@@ -0,0 +1,308 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Implementation of the quarantine of the motes that failed the attestation. See
+// attest-quarantine.h for the description of the functionality and of the frame.
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------- Imports of the libraries -------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+#include "attest-quarantine.h"
+#include "attest-shard.h"
+#include "attest-stats.h"
+#include "net/netstack.h"
+#include "net/ipv6/simple-udp.h"
+#include "random.h"
+#include "sys/ctimer.h"
+#include "sys/log.h"
+#include <string.h>
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Initialize ----------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Initialize the parameters for the logging module
+#define LOG_MODULE "Quarantine"
+#define LOG_LEVEL LOG_LEVEL_INFO
+
+// Initialize the header of a frame: magic and count
+#define FRAME_MAGIC      'Q'
+#define FRAME_HEADER_LEN 2
+
+// Initialize the number of frames with the same list after which a mote does not send its own in
+// a Trickle interval
+#define TRICKLE_REDUNDANCY 1
+
+// Initialize the sorted list of the quarantined mote IDs
+static uint16_t ids[ATTEST_QUARANTINE_MAX];
+static uint8_t count;
+
+// Create the UDP connection of the frames and the Trickle timer of the sending
+static struct simple_udp_connection quarantine_conn;
+static struct ctimer trickle_timer;
+
+// Initialize the state of the Trickle timer: the current interval, the time from the sending to the
+// end of the interval and the number of frames with the same list heard in the interval
+static clock_time_t interval;
+static clock_time_t interval_rest;
+static uint8_t heard;
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- Functions ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Returns the ID of a mote from its address, the last 16 bits of the interface identifier
+static uint16_t
+mote_id(const uip_ipaddr_t *addr)
+{
+  return ((uint16_t)addr->u8[14] << 8) | addr->u8[15];
+}
+
+// Returns the position of the ID in the list, or the position where it would be inserted
+static uint8_t
+search(uint16_t id)
+{
+  uint8_t low = 0, high = count, mid;
+  while(low < high) {
+    mid = (low + high) / 2;
+    if(ids[mid] < id) {
+      low = mid + 1;
+    }
+    else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+// Returns true if the ID is in the list
+static bool
+contains_id(uint16_t id)
+{
+  uint8_t pos = search(id);
+  return pos < count && ids[pos] == id;
+}
+
+// Returns true if the ID is one of the attestation servers, they are never quarantined
+static bool
+is_server_id(uint16_t id)
+{
+  return id >= 1 && id <= ATTEST_SERVER_COUNT;
+}
+
+// Returns the ID i of a received frame
+static uint16_t
+frame_id(const uint8_t *data, uint8_t i)
+{
+  return ((uint16_t)data[FRAME_HEADER_LEN + 2 * i] << 8) | data[FRAME_HEADER_LEN + 2 * i + 1];
+}
+
+// Send the list to the neighbours
+static void
+send_list(void *ptr)
+{
+  static uint8_t frame[FRAME_HEADER_LEN + 2 * ATTEST_QUARANTINE_MAX];
+  uip_ipaddr_t addr;
+  uint8_t i;
+
+  frame[0] = FRAME_MAGIC;
+  frame[1] = count;
+  for(i = 0; i < count; i++) {
+    frame[FRAME_HEADER_LEN + 2 * i] = ids[i] >> 8;
+    frame[FRAME_HEADER_LEN + 2 * i + 1] = ids[i] & 0xff;
+  }
+  uip_create_linklocal_allnodes_mcast(&addr);
+  simple_udp_sendto(&quarantine_conn, frame, FRAME_HEADER_LEN + 2 * count, &addr);
+}
+
+static void trickle_send(void *ptr);
+
+// Start a Trickle interval, the list is sent at a random time in the second half of the interval
+static void
+trickle_start(void)
+{
+  clock_time_t t = interval / 2 + random_rand() % (interval / 2 + 1);
+  interval_rest = interval - t;
+  heard = 0;
+  ctimer_set(&trickle_timer, t, trickle_send, NULL);
+}
+
+// End of a Trickle interval, the next one is twice as long
+static void
+trickle_end(void *ptr)
+{
+  interval = interval < ATTEST_QUARANTINE_REFRESH / 2 ? 2 * interval : ATTEST_QUARANTINE_REFRESH;
+  trickle_start();
+}
+
+// Send the list unless the neighbours already sent the same list in this interval
+static void
+trickle_send(void *ptr)
+{
+  if(heard < TRICKLE_REDUNDANCY) {
+    send_list(NULL);
+  }
+  ctimer_set(&trickle_timer, interval_rest, trickle_end, NULL);
+}
+
+// The list changed or a neighbour has an older list: start again with the shortest interval. An
+// interval that is already the shortest one is kept, its frame sends the list as it is at that time
+static void
+trickle_reset(void)
+{
+  if(ctimer_expired(&trickle_timer) || interval != ATTEST_QUARANTINE_DELAY) {
+    interval = ATTEST_QUARANTINE_DELAY;
+    trickle_start();
+  }
+}
+
+// Merge the IDs of a received frame into the list. Returns true if the list grew
+static bool
+merge(const uint8_t *data, uint8_t n)
+{
+  uint16_t merged[ATTEST_QUARANTINE_MAX];
+  uint8_t i = 0, j = 0, k = 0;
+  bool grown = false;
+
+  while((i < count || j < n) && k < ATTEST_QUARANTINE_MAX) {
+    if(j >= n || (i < count && ids[i] <= frame_id(data, j))) {
+      if(j < n && ids[i] == frame_id(data, j)) {
+        j++;
+      }
+      merged[k++] = ids[i++];
+    }
+    else {
+      uint16_t id = frame_id(data, j++);
+      if(!is_server_id(id)) {
+        merged[k++] = id;
+        grown = true;
+      }
+    }
+  }
+  if(i < count || j < n) {
+    LOG_WARN("The quarantine list is full, %u motes are not stored\n",
+             (unsigned)((count - i) + (n - j)));
+  }
+  memcpy(ids, merged, k * sizeof(ids[0]));
+  count = k;
+  return grown;
+}
+
+// Call back function. This function is used to process the frames of the neighbours
+static void
+quarantine_rx_callback(struct simple_udp_connection *c,
+                       const uip_ipaddr_t *sender_addr,
+                       uint16_t sender_port,
+                       const uip_ipaddr_t *receiver_addr,
+                       uint16_t receiver_port,
+                       const uint8_t *data,
+                       uint16_t datalen)
+{
+  uint8_t n, i;
+
+  // The frame has to be complete and its IDs sorted, otherwise the merge is not valid
+  if(datalen < FRAME_HEADER_LEN || data[0] != FRAME_MAGIC ||
+     datalen != FRAME_HEADER_LEN + 2 * data[1]) {
+    LOG_WARN("Dropping an invalid quarantine frame from IP: '");
+    LOG_WARN_6ADDR(sender_addr);
+    LOG_WARN_("'\n");
+    return;
+  }
+  n = data[1];
+  for(i = 1; i < n; i++) {
+    if(frame_id(data, i - 1) >= frame_id(data, i)) {
+      LOG_WARN("Dropping an unsorted quarantine frame\n");
+      return;
+    }
+  }
+  // A list that grew is sent on soon, as well as the list of a mote whose neighbour has a shorter
+  // list. The same list only counts for the suppression, so every flood ends by itself
+  if(merge(data, n)) {
+    LOG_INFO("The quarantine list has %u motes\n", count);
+    trickle_reset();
+  }
+  else if(count > n) {
+    trickle_reset();
+  }
+  else if(heard < 0xff) {
+    heard++;
+  }
+}
+
+// IP packet processor. It drops the received and forwarded packets of a quarantined mote before
+// any parsing
+static enum netstack_ip_action
+ip_input(void)
+{
+  if(count > 0 && contains_id(mote_id(&UIP_IP_BUF->srcipaddr))) {
+    attest_stats_inc(ATTEST_STAT_QUARANTINE_DROPPED);
+    return NETSTACK_IP_DROP;
+  }
+  return NETSTACK_IP_PROCESS;
+}
+
+// IP packet processor. It drops the packets sent to a quarantined mote, the multicast addresses
+// are not mote addresses
+static enum netstack_ip_action
+ip_output(const linkaddr_t *localdest)
+{
+  if(count > 0 && !uip_is_addr_mcast(&UIP_IP_BUF->destipaddr) &&
+     contains_id(mote_id(&UIP_IP_BUF->destipaddr))) {
+    attest_stats_inc(ATTEST_STAT_QUARANTINE_DROPPED);
+    return NETSTACK_IP_DROP;
+  }
+  return NETSTACK_IP_PROCESS;
+}
+
+static struct netstack_ip_packet_processor packet_processor = {
+  .process_input = ip_input,
+  .process_output = ip_output
+};
+
+void
+attest_quarantine_init(void)
+{
+  simple_udp_register(&quarantine_conn, UDP_QUARANTINE_PORT, NULL, UDP_QUARANTINE_PORT,
+                      quarantine_rx_callback);
+  netstack_ip_packet_processor_add(&packet_processor);
+  count = 0;
+  interval = ATTEST_QUARANTINE_DELAY;
+  ctimer_stop(&trickle_timer);
+}
+
+int
+attest_quarantine_add(const uip_ipaddr_t *addr)
+{
+  uint16_t id = mote_id(addr);
+  uint8_t pos = search(id);
+
+  if(is_server_id(id) || (pos < count && ids[pos] == id)) {
+    return ATTEST_QUARANTINE_KNOWN;
+  }
+  if(count == ATTEST_QUARANTINE_MAX) {
+    LOG_WARN("The quarantine list is full, the mote %u is not stored\n", id);
+    return ATTEST_QUARANTINE_FULL;
+  }
+  memmove(&ids[pos + 1], &ids[pos], (count - pos) * sizeof(ids[0]));
+  ids[pos] = id;
+  count++;
+  trickle_reset();
+  return ATTEST_QUARANTINE_ADDED;
+}
+
+bool
+attest_quarantine_contains(const uip_ipaddr_t *addr)
+{
+  return count > 0 && contains_id(mote_id(addr));
+}
+
+uint8_t
+attest_quarantine_count(void)
+{
+  return count;
+}
+/*------------------------------------------------------------------------------------------------*/
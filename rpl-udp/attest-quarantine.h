@@ -0,0 +1,98 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Quarantine of the motes that failed the attestation. The functionality is:
+// * A server that rejects the key of a mote adds the mote to the quarantine list. The list is a
+//   sorted array of 16 bit mote IDs (the last 16 bits of the interface identifier, the Cooja mote
+//   ID), so that the check of an address is a binary search.
+// * The list is flooded down the DODAG as a compact binary frame on UDP_QUARANTINE_PORT to the
+//   link-local all-nodes address:
+//     'Q' <count> <count sorted IDs, 2 bytes each>   (network byte order)
+//   A mote merges a received list into its own (union). The list only grows: a quarantine is never
+//   lifted, a mote leaves the list only when every mote restarts. The frame carries no version,
+//   the union of the lists is the same whatever the order of the frames.
+// * Every mote with a non-empty list sends it to its neighbours with a Trickle timer (RFC 6206):
+//   the interval starts at ATTEST_QUARANTINE_DELAY, doubles up to ATTEST_QUARANTINE_REFRESH while
+//   the neighbours send the same list, and a mote does not send when it already heard the same
+//   list in the interval. A list that grew or a neighbour with a shorter list starts the interval
+//   again, so a flood spreads in seconds and a quiet network sends little, only locally. The
+//   periodic frames reach the motes that missed a frame or joined later.
+// * Every mote registers an IP packet processor that drops, before any parsing, the packets that
+//   come from a quarantined mote, the packets it would forward for it and the packets sent to it.
+//   They are counted in ATTEST_STAT_QUARANTINE_DROPPED (attest-stats.h).
+//
+// The servers are never quarantined. Like the other messages of the scheme the frames are not
+// authenticated.
+
+#ifndef ATTEST_QUARANTINE_H_
+#define ATTEST_QUARANTINE_H_
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------- Imports of the libraries -------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Initialize ----------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Initialize the maximum number of quarantined motes, the count of a frame is one byte
+#ifdef ATTEST_CONF_QUARANTINE_MAX
+#define ATTEST_QUARANTINE_MAX ATTEST_CONF_QUARANTINE_MAX
+#else
+#define ATTEST_QUARANTINE_MAX 32
+#endif
+
+#if ATTEST_QUARANTINE_MAX < 1 || ATTEST_QUARANTINE_MAX > 255
+#error "ATTEST_QUARANTINE_MAX must be between 1 and 255"
+#endif
+
+// Initialize the result of attest_quarantine_add
+#define ATTEST_QUARANTINE_ADDED 0
+#define ATTEST_QUARANTINE_KNOWN 1  // already in the list, or a server
+#define ATTEST_QUARANTINE_FULL  2
+
+// Initialize the port of the quarantine frames
+#define UDP_QUARANTINE_PORT 5680
+
+// Initialize the shortest interval of the Trickle timer, a mote sends its updated list to its
+// neighbours after a random delay between the half and the whole of it
+#ifdef ATTEST_CONF_QUARANTINE_DELAY
+#define ATTEST_QUARANTINE_DELAY ATTEST_CONF_QUARANTINE_DELAY
+#else
+#define ATTEST_QUARANTINE_DELAY (2 * CLOCK_SECOND)
+#endif
+
+// Initialize the longest interval of the Trickle timer
+#ifdef ATTEST_CONF_QUARANTINE_REFRESH
+#define ATTEST_QUARANTINE_REFRESH ATTEST_CONF_QUARANTINE_REFRESH
+#else
+#define ATTEST_QUARANTINE_REFRESH (600 * (clock_time_t)CLOCK_SECOND)
+#endif
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- Functions ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Start the quarantine with an empty list: register the UDP connection of the frames and the IP
+// packet processor. It has to be called from the main process of every mote
+void attest_quarantine_init(void);
+
+// Server side: add the mote with the given address to the list and send the list. Returns one of
+// ATTEST_QUARANTINE_*
+int attest_quarantine_add(const uip_ipaddr_t *addr);
+
+// Returns true if the mote with the given address is quarantined
+bool attest_quarantine_contains(const uip_ipaddr_t *addr);
+
+// Returns the number of quarantined motes
+uint8_t attest_quarantine_count(void);
+
+#endif /* ATTEST_QUARANTINE_H_ */
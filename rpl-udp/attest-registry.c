@@ -0,0 +1,84 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Implementation of the registry of the known motes. See attest-registry.h for the description of
+// the functionality.
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------- Imports of the libraries -------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+#include "attest-registry.h"
+#include <string.h>
+
+/*--------------------------------------------------------------------------------------------------
+---------------------------------- Initialize arrays for the nodes ---------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Initialize the remote keys array
+char remotekeys[MAX_NODES][ATTEST_KEY_SIZE];
+
+// Initialize the sender port array
+uint16_t sender_ports[MAX_NODES];
+
+// Initialize the IP array
+uip_ipaddr_t sender_addrs[MAX_NODES];
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- Functions ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+int
+attest_registry_check(const uip_ipaddr_t *addr, uint16_t port, const struct attest_msg *msg,
+                      int *index)
+{
+  int empty = MAX_NODES;
+  int i;
+
+  // Search the whole arrays first, a mote can be stored after an empty cell when a mote was removed
+  for(i = 0; i < MAX_NODES; i++) {
+    if(sender_ports[i] == port && uip_ipaddr_cmp(&sender_addrs[i], addr)) {
+      *index = i;
+      return attest_msg_key_equals(msg, remotekeys[i]) ?
+        ATTEST_REGISTRY_VERIFIED : ATTEST_REGISTRY_REJECTED;
+    }
+    if(sender_ports[i] == 0 && empty == MAX_NODES) {
+      empty = i;
+    }
+  }
+
+  // In this case the mote has sent a message for the first time, it is stored in an empty cell
+  *index = empty;
+  if(empty == MAX_NODES) {
+    return ATTEST_REGISTRY_FULL;
+  }
+  attest_msg_copy_key(msg, remotekeys[empty]);
+  sender_ports[empty] = port;
+  uip_ipaddr_copy(&sender_addrs[empty], addr);
+  return ATTEST_REGISTRY_ENROLLED;
+}
+
+void
+attest_registry_remove(int i)
+{
+  remotekeys[i][0] = '\0';
+  sender_ports[i] = 0;
+  memset(&sender_addrs[i], 0, sizeof(sender_addrs[i]));
+}
+
+int
+attest_registry_count(void)
+{
+  int count = 0;
+  int i;
+  for(i = 0; i < MAX_NODES; i++) {
+    if(sender_ports[i] != 0) {
+      count++;
+    }
+  }
+  return count;
+}
+/*------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,58 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Registry of the known motes, shared by the server and the clients. Each cell of the arrays keeps
+// the IP, port and key of a mote that sent a message. The first message of a mote stores it in an
+// empty cell, the following messages have to carry the same key or they are rejected.
+
+#ifndef ATTEST_REGISTRY_H_
+#define ATTEST_REGISTRY_H_
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------- Imports of the libraries -------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+#include "net/ipv6/uip.h"
+#include "attest-msg.h"
+#include <stdint.h>
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Initialize ----------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Initialize the maximum nodes, it can be overridden from the build (DEFINES=MAX_NODES=<n>)
+#ifndef MAX_NODES
+#define MAX_NODES 10
+#endif
+
+// Initialize the result of the check of a message
+#define ATTEST_REGISTRY_VERIFIED 0
+#define ATTEST_REGISTRY_ENROLLED 1
+#define ATTEST_REGISTRY_REJECTED 2
+#define ATTEST_REGISTRY_FULL     3
+
+// The remote keys, sender ports and IP arrays. A cell is empty when its port is 0
+extern char remotekeys[MAX_NODES][ATTEST_KEY_SIZE];
+extern uint16_t sender_ports[MAX_NODES];
+extern uip_ipaddr_t sender_addrs[MAX_NODES];
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- Functions ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Check the key of a message against the arrays. A known mote is verified or rejected, a new mote
+// is stored in an empty cell. Returns ATTEST_REGISTRY_* and in index the cell of the mote, or
+// MAX_NODES if the arrays are full
+int attest_registry_check(const uip_ipaddr_t *addr, uint16_t port, const struct attest_msg *msg,
+                          int *index);
+
+// Empty the cell i of the arrays
+void attest_registry_remove(int i);
+
+// Returns the number of the motes in the arrays
+int attest_registry_count(void);
+
+#endif /* ATTEST_REGISTRY_H_ */
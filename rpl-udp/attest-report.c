@@ -0,0 +1,95 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Implementation of the periodic report of the traffic and the radio time. See attest-report.h for
+// the description of the functionality.
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------- Imports of the libraries -------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+#include "attest-report.h"
+#include "attest-quarantine.h"
+#include "attest-stats.h"
+#include "net/ipv6/uip.h"
+#include "sys/energest.h"
+#include "sys/ctimer.h"
+#include "sys/log.h"
+#include <stdint.h>
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Initialize ----------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Initialize the parameters for the logging module
+#define LOG_MODULE "Report"
+#define LOG_LEVEL LOG_LEVEL_INFO
+
+// Create the timer of the report
+static struct ctimer report_timer;
+
+// Initialize the values of the previous report, the report prints the difference. The uIP
+// counters are of the type uip_stats_t and wrap around, the difference is taken in the same type.
+#if UIP_STATISTICS
+static uip_stats_t last_udp_tx, last_udp_rx, last_ip_fwd;
+#endif
+static uint64_t last_radio_tx, last_radio_listen;
+
+// Initialize the value of the previous report of the statistics counter. The counters can be reset
+// by a query, the difference is then the counter itself
+static uint32_t last_dropped;
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- Functions ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Convert energest ticks to milliseconds
+static unsigned long
+to_ms(uint64_t ticks)
+{
+  return (unsigned long)(ticks * 1000 / ENERGEST_SECOND);
+}
+
+// Print the report and start the timer again
+static void
+report(void *ptr)
+{
+  unsigned long udp_tx = 0, udp_rx = 0, ip_fwd = 0;
+  uint64_t radio_tx, radio_listen;
+  uint32_t dropped = attest_stats_get(ATTEST_STAT_QUARANTINE_DROPPED);
+
+#if UIP_STATISTICS
+  udp_tx = (uip_stats_t)(uip_stat.udp.sent - last_udp_tx);
+  udp_rx = (uip_stats_t)(uip_stat.udp.recv - last_udp_rx);
+  ip_fwd = (uip_stats_t)(uip_stat.ip.forwarded - last_ip_fwd);
+  last_udp_tx = uip_stat.udp.sent;
+  last_udp_rx = uip_stat.udp.recv;
+  last_ip_fwd = uip_stat.ip.forwarded;
+#endif
+
+  energest_flush();
+  radio_tx = energest_type_time(ENERGEST_TYPE_TRANSMIT);
+  radio_listen = energest_type_time(ENERGEST_TYPE_LISTEN);
+
+  LOG_INFO("Hourly report: udp tx %lu rx %lu fwd %lu, radio tx %lu ms listen %lu ms, "
+           "quarantine %u motes dropped %lu\n",
+           udp_tx, udp_rx, ip_fwd, to_ms(radio_tx - last_radio_tx),
+           to_ms(radio_listen - last_radio_listen), attest_quarantine_count(),
+           (unsigned long)(dropped >= last_dropped ? dropped - last_dropped : dropped));
+
+  last_radio_tx = radio_tx;
+  last_radio_listen = radio_listen;
+  last_dropped = dropped;
+
+  ctimer_reset(&report_timer);
+}
+
+void
+attest_report_init(void)
+{
+  ctimer_set(&report_timer, ATTEST_REPORT_INTERVAL, report, NULL);
+}
+/*------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,42 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Periodic report of the traffic and the radio time of a mote. Every ATTEST_REPORT_INTERVAL the mote
+// prints the number of UDP packets sent and received, the packets it forwarded, the radio
+// transmit and listen time and the packets dropped by the quarantine (attest-quarantine.h), all
+// for the last interval, with the number of quarantined motes. The default interval is one hour so
+// the values are directly per hour:
+//   Hourly report: udp tx <n> rx <n> fwd <n>, radio tx <ms> ms listen <ms> ms, quarantine <n> motes
+//   dropped <n>
+
+#ifndef ATTEST_REPORT_H_
+#define ATTEST_REPORT_H_
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------- Imports of the libraries -------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+#include "contiki.h"
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Initialize ----------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Initialize the interval of the report
+#ifdef ATTEST_CONF_REPORT_INTERVAL
+#define ATTEST_REPORT_INTERVAL ATTEST_CONF_REPORT_INTERVAL
+#else
+#define ATTEST_REPORT_INTERVAL (3600 * (clock_time_t)CLOCK_SECOND)
+#endif
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- Functions ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Start the periodic report, it has to be called from the main process of the mote
+void attest_report_init(void);
+
+#endif /* ATTEST_REPORT_H_ */
@@ -0,0 +1,241 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Implementation of the sharding of the attestation work over several servers. See attest-shard.h
+// for the description of the functionality.
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------- Imports of the libraries -------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+#include "attest-shard.h"
+#include "net/routing/routing.h"
+#include "net/netstack.h"
+#include "net/ipv6/uip-ds6.h"
+#include "sys/node-id.h"
+#include <string.h>
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Initialize ----------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Initialize the mask with all the configured servers
+#define ALL_SERVERS_MASK ((uint16_t)(0xffffu >> (ATTEST_MAX_SERVERS - ATTEST_SERVER_COUNT)))
+
+// Initialize the mask of the live servers
+static uint16_t live_mask = ALL_SERVERS_MASK;
+
+// Initialize the time each server was last heard (server side)
+static clock_time_t last_heard[ATTEST_SERVER_COUNT];
+
+// Initialize the number of unanswered hello messages per server (client side)
+static uint8_t missed[ATTEST_SERVER_COUNT];
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- Functions ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Rendezvous hash of the interface identifier of a mote and the index of a server. The FNV-1a hash
+// is followed by a final mix so that the servers get an even share even with sequential IDs.
+static uint32_t
+shard_weight(const uip_ipaddr_t *addr, uint8_t index)
+{
+  uint32_t h = 2166136261u;
+  int i;
+  for(i = 8; i < 16; i++) {
+    h = (h ^ addr->u8[i]) * 16777619u;
+  }
+  h = (h ^ index) * 16777619u;
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  return h;
+}
+
+void
+attest_shard_init(void)
+{
+  clock_time_t now = clock_time();
+  int i;
+  live_mask = ALL_SERVERS_MASK;
+  for(i = 0; i < ATTEST_SERVER_COUNT; i++) {
+    last_heard[i] = now;
+    missed[i] = 0;
+  }
+}
+
+bool
+attest_shard_is_server(void)
+{
+  return node_id >= 1 && node_id <= ATTEST_SERVER_COUNT;
+}
+
+uint8_t
+attest_shard_self(void)
+{
+  return (uint8_t)(node_id - 1);
+}
+
+uint8_t
+attest_shard_owner(const uip_ipaddr_t *addr)
+{
+  uint8_t best = 0;
+  uint32_t best_weight = 0;
+  bool found = false;
+  uint8_t i;
+
+  for(i = 0; i < ATTEST_SERVER_COUNT; i++) {
+    if(live_mask & (1u << i)) {
+      uint32_t w = shard_weight(addr, i);
+      if(!found || w > best_weight) {
+        best = i;
+        best_weight = w;
+        found = true;
+      }
+    }
+  }
+  return best;
+}
+
+void
+attest_shard_server_addr(uint8_t index, uip_ipaddr_t *addr)
+{
+  // The Cooja motes derive the link layer address from the mote ID, the ID is repeated in every
+  // 16 bits of the address. The server with index i is the mote with ID i + 1.
+  uip_lladdr_t lladdr;
+  uint16_t id = index + 1;
+  int i;
+  for(i = 0; i < (int)sizeof(lladdr.addr); i += 2) {
+    lladdr.addr[i] = id >> 8;
+    lladdr.addr[i + 1] = id & 0xff;
+  }
+  uip_ip6addr(addr, UIP_DS6_DEFAULT_PREFIX, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(addr, &lladdr);
+}
+
+uint8_t
+attest_shard_server_index(const uip_ipaddr_t *addr)
+{
+  uip_ipaddr_t server_addr;
+  uint8_t i;
+  for(i = 0; i < ATTEST_SERVER_COUNT; i++) {
+    attest_shard_server_addr(i, &server_addr);
+    if(memcmp(&server_addr.u8[8], &addr->u8[8], 8) == 0) {
+      return i;
+    }
+  }
+  return ATTEST_MAX_SERVERS;
+}
+
+bool
+attest_shard_get_server(uip_ipaddr_t *addr)
+{
+#if ATTEST_SERVER_COUNT > 1
+  uip_ds6_addr_t *self;
+  if(!NETSTACK_ROUTING.get_root_ipaddr(addr)) {
+    return false;
+  }
+  self = uip_ds6_get_global(ADDR_PREFERRED);
+  if(self == NULL) {
+    return false;
+  }
+  attest_shard_server_addr(attest_shard_owner(&self->ipaddr), addr);
+  return true;
+#else
+  // Single server, the server is the RPL root
+  return NETSTACK_ROUTING.get_root_ipaddr(addr);
+#endif
+}
+
+uint16_t
+attest_shard_live_mask(void)
+{
+  return live_mask;
+}
+
+void
+attest_shard_set_live_mask(uint16_t mask)
+{
+  mask &= ALL_SERVERS_MASK;
+  if(attest_shard_is_server()) {
+    mask |= 1u << attest_shard_self();
+  }
+  // Never end up without a server, in that case start again with all of them
+  live_mask = mask != 0 ? mask : ALL_SERVERS_MASK;
+}
+
+bool
+attest_shard_heard(uint8_t index)
+{
+  bool was_down;
+  if(index >= ATTEST_SERVER_COUNT) {
+    return false;
+  }
+  was_down = (live_mask & (1u << index)) == 0;
+  last_heard[index] = clock_time();
+  live_mask |= 1u << index;
+  return was_down;
+}
+
+uint16_t
+attest_shard_expire(void)
+{
+  clock_time_t now = clock_time();
+  uint16_t removed = 0;
+  uint8_t i;
+  for(i = 0; i < ATTEST_SERVER_COUNT; i++) {
+    if(attest_shard_is_server() && i == attest_shard_self()) {
+      continue;
+    }
+    if((live_mask & (1u << i)) && now - last_heard[i] > ATTEST_SHARD_TIMEOUT) {
+      live_mask &= ~(1u << i);
+      removed |= 1u << i;
+    }
+  }
+  return removed;
+}
+
+uint16_t
+attest_shard_reconcile(uint16_t peer_mask)
+{
+  clock_time_t now = clock_time();
+  uint16_t removed = 0;
+  uint8_t i;
+  for(i = 0; i < ATTEST_SERVER_COUNT; i++) {
+    if(attest_shard_is_server() && i == attest_shard_self()) {
+      continue;
+    }
+    if((live_mask & (1u << i)) && !(peer_mask & (1u << i)) &&
+       now - last_heard[i] > ATTEST_SHARD_HEARTBEAT) {
+      live_mask &= ~(1u << i);
+      removed |= 1u << i;
+    }
+  }
+  return removed;
+}
+
+void
+attest_shard_answered(uint8_t index)
+{
+  if(index < ATTEST_SERVER_COUNT) {
+    missed[index] = 0;
+  }
+}
+
+bool
+attest_shard_missed(uint8_t index)
+{
+  if(index >= ATTEST_SERVER_COUNT || (live_mask & (1u << index)) == 0) {
+    return false;
+  }
+  if(++missed[index] < ATTEST_SHARD_CLIENT_MISSES) {
+    return false;
+  }
+  missed[index] = 0;
+  attest_shard_set_live_mask(live_mask & ~(1u << index));
+  return true;
+}
+/*------------------------------------------------------------------------------------------------*/
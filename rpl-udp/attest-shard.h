@@ -0,0 +1,124 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Sharding of the attestation work over several attestation servers. The functionality is:
+// * The servers are the motes with ID 1 .. ATTEST_SERVER_COUNT. Mote 1 is also the RPL root.
+// * Each client is owned by exactly one live server. The owner is selected with rendezvous
+//   (highest random weight) hashing of the client interface identifier, so when a server fails
+//   only the clients of that server move and every other client stays where it is.
+// * Every server keeps a mask of the live servers. The servers send each other a heartbeat on the
+//   UDP_SHARD_PORT with the number of clients they own and their live mask, and a server that is
+//   not heard for ATTEST_SHARD_TIMEOUT is removed from the mask. A server that is missing from
+//   the mask of a peer and was not heard for more than one heartbeat interval is removed at once,
+//   so the servers agree on the owners of the clients without waiting for their own timeouts.
+// * The clients keep their own copy of the mask. A server that is not answering for
+//   ATTEST_SHARD_CLIENT_MISSES hello messages is removed, and a server that redirects a client
+//   with a "moved" message hands over its mask.
+//
+// With ATTEST_SERVER_COUNT set to 1 (the default) the single server is the RPL root and the
+// behaviour is the same as the original single-server design.
+
+#ifndef ATTEST_SHARD_H_
+#define ATTEST_SHARD_H_
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------- Imports of the libraries -------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Initialize ----------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Initialize the number of attestation servers, the maximum is limited by the live mask width
+#ifdef ATTEST_CONF_SERVER_COUNT
+#define ATTEST_SERVER_COUNT ATTEST_CONF_SERVER_COUNT
+#else
+#define ATTEST_SERVER_COUNT 1
+#endif
+
+#define ATTEST_MAX_SERVERS 16
+
+#if ATTEST_SERVER_COUNT < 1 || ATTEST_SERVER_COUNT > ATTEST_MAX_SERVERS
+#error "ATTEST_SERVER_COUNT must be between 1 and ATTEST_MAX_SERVERS"
+#endif
+
+// Initialize the port used by the servers to exchange the shard ownership
+#define UDP_SHARD_PORT 5679
+
+// Initialize the heartbeat interval of the servers and the time after which a silent server is
+// considered down
+#ifdef ATTEST_CONF_SHARD_HEARTBEAT
+#define ATTEST_SHARD_HEARTBEAT ATTEST_CONF_SHARD_HEARTBEAT
+#else
+#define ATTEST_SHARD_HEARTBEAT (30 * CLOCK_SECOND)
+#endif
+
+#ifdef ATTEST_CONF_SHARD_TIMEOUT
+#define ATTEST_SHARD_TIMEOUT ATTEST_CONF_SHARD_TIMEOUT
+#else
+#define ATTEST_SHARD_TIMEOUT (3 * ATTEST_SHARD_HEARTBEAT)
+#endif
+
+// Initialize the number of unanswered hello messages after which a client drops its server
+#ifdef ATTEST_CONF_SHARD_CLIENT_MISSES
+#define ATTEST_SHARD_CLIENT_MISSES ATTEST_CONF_SHARD_CLIENT_MISSES
+#else
+#define ATTEST_SHARD_CLIENT_MISSES 3
+#endif
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- Functions ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Initialize the shard state, every server is considered live at start
+void attest_shard_init(void);
+
+// Returns true if this mote is one of the attestation servers
+bool attest_shard_is_server(void);
+
+// Returns the index of this mote in the list of servers (only valid on a server)
+uint8_t attest_shard_self(void);
+
+// Returns the index of the live server that owns the mote with the given address
+uint8_t attest_shard_owner(const uip_ipaddr_t *addr);
+
+// Returns in addr the global IPv6 address of the server with the given index
+void attest_shard_server_addr(uint8_t index, uip_ipaddr_t *addr);
+
+// Returns the index of the server with the given address, or ATTEST_MAX_SERVERS if it is not one
+uint8_t attest_shard_server_index(const uip_ipaddr_t *addr);
+
+// Returns in addr the address of the server that owns this mote. Returns false if the network
+// is not ready yet
+bool attest_shard_get_server(uip_ipaddr_t *addr);
+
+// Get and set the mask of the live servers, bit i is the server with index i
+uint16_t attest_shard_live_mask(void);
+void attest_shard_set_live_mask(uint16_t mask);
+
+// Server side: record a heartbeat of a peer. Returns true if the peer was down before
+bool attest_shard_heard(uint8_t index);
+
+// Server side: remove the peers that were not heard for ATTEST_SHARD_TIMEOUT. Returns the mask of
+// the peers that were removed
+uint16_t attest_shard_expire(void);
+
+// Server side: reconcile the live mask with the mask of a peer, the servers that the peer does not
+// see and that were not heard for more than ATTEST_SHARD_HEARTBEAT are removed. A server is never
+// added from the mask of a peer, only from its own heartbeat. Returns the mask of the removed peers
+uint16_t attest_shard_reconcile(uint16_t peer_mask);
+
+// Client side: record that the server with the given index answered or missed a hello message.
+// attest_shard_missed returns true if the server was removed from the live mask
+void attest_shard_answered(uint8_t index);
+bool attest_shard_missed(uint8_t index);
+
+#endif /* ATTEST_SHARD_H_ */
@@ -0,0 +1,335 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Implementation of the runtime statistics of a mote. See attest-stats.h for the description of the
+// functionality and of the messages.
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------- Imports of the libraries -------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+#include "attest-stats.h"
+#include "attest-registry.h"
+#include "attest-quarantine.h"
+#include "sys/node-id.h"
+#include "sys/ctimer.h"
+#include "sys/log.h"
+#include <string.h>
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Initialize ----------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Initialize the parameters for the logging module
+#define LOG_MODULE "Stats"
+#define LOG_LEVEL LOG_LEVEL_INFO
+
+// Initialize the length of the query and of the longest response
+#define QUERY_LEN        6
+#define RESPONSE_MAX_LEN (ATTEST_STATS_HEADER_LEN + ATTEST_STATS_PAGE_LEN)
+
+// Initialize the longest value that is never split between two pages: the role, the node ID and the
+// uptime. A page holds whole values, so it is at least ATTEST_STATS_PAGE_LEN - VALUE_MAX + 1 long
+#define VALUE_MAX 7
+
+#if ATTEST_STATS_PAGE_LEN < VALUE_MAX || \
+    ATTEST_STATS_BODY_MAX > 255 * (ATTEST_STATS_PAGE_LEN - VALUE_MAX + 1)
+#error "ATTEST_STATS_PAGE_LEN is out of range"
+#endif
+
+// Create the pages of a body being built: the start of the current page, the end of the last whole
+// value, the number of the current page and the part of the body of the requested page
+struct pager {
+  const uint8_t *start;
+  const uint8_t *last;
+  uint8_t page;
+  uint8_t want;
+  const uint8_t *from;
+  const uint8_t *to;
+};
+
+// Initialize the counters, the gauges and the histograms
+static uint32_t counters[ATTEST_STAT_COUNT];
+static uint16_t gauges[ATTEST_GAUGE_COUNT];
+static uint32_t histograms[ATTEST_HIST_COUNT][ATTEST_HIST_BUCKETS];
+
+// Initialize the role of the mote
+static uint8_t stats_role;
+
+// Create the UDP connection of the queries
+static struct simple_udp_connection stats_conn;
+
+// Create the timer of the polling and the index of the next polled mote (server side)
+#if ATTEST_STATS_POLL
+static struct ctimer poll_timer;
+static int poll_index;
+#endif
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- Functions ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Write the values in network byte order
+static uint8_t *
+put16(uint8_t *p, uint16_t value)
+{
+  p[0] = value >> 8;
+  p[1] = value & 0xff;
+  return p + 2;
+}
+
+static uint8_t *
+put32(uint8_t *p, uint32_t value)
+{
+  p[0] = value >> 24;
+  p[1] = (value >> 16) & 0xff;
+  p[2] = (value >> 8) & 0xff;
+  p[3] = value & 0xff;
+  return p + 4;
+}
+
+// Returns the bucket of a value, the number of its significant bits
+static uint8_t
+bucket(uint32_t value)
+{
+  uint8_t b = 0;
+  while(value != 0 && b < ATTEST_HIST_BUCKETS - 1) {
+    value >>= 1;
+    b++;
+  }
+  return b;
+}
+
+void
+attest_stats_add(uint8_t counter, uint32_t value)
+{
+  if(counter < ATTEST_STAT_COUNT) {
+    counters[counter] += value;
+  }
+}
+
+uint32_t
+attest_stats_get(uint8_t counter)
+{
+  return counter < ATTEST_STAT_COUNT ? counters[counter] : 0;
+}
+
+void
+attest_stats_set_gauge(uint8_t gauge, uint16_t value)
+{
+  if(gauge < ATTEST_GAUGE_COUNT) {
+    gauges[gauge] = value;
+  }
+}
+
+void
+attest_stats_record(uint8_t hist, uint32_t value)
+{
+  if(hist < ATTEST_HIST_COUNT) {
+    histograms[hist][bucket(value)]++;
+  }
+}
+
+int
+attest_stats_sendto(struct simple_udp_connection *c, const void *data, uint16_t datalen,
+                    const uip_ipaddr_t *to)
+{
+  counters[ATTEST_STAT_TX]++;
+  counters[ATTEST_STAT_TX_BYTES] += datalen;
+  histograms[ATTEST_HIST_TX_BYTES][bucket(datalen)]++;
+  return simple_udp_sendto(c, data, datalen, to);
+}
+
+// A whole value of the body ends at p. A page ends before the value that does not fit in it, so the
+// pages fetched by separate queries never mix the bytes of one value from two different times
+static void
+page_value(struct pager *pg, const uint8_t *p)
+{
+  if(p - pg->start > ATTEST_STATS_PAGE_LEN) {
+    pg->page++;
+    pg->start = pg->last;
+  }
+  pg->last = p;
+  if(pg->page == pg->want) {
+    pg->from = pg->start;
+    pg->to = p;
+  }
+}
+
+uint16_t
+attest_stats_response(const uint8_t *query, uint16_t query_len, uint8_t *buf, uint16_t size)
+{
+  uint8_t *p = buf + ATTEST_STATS_HEADER_LEN;
+  struct pager pg = { p, p, 0, 0, NULL, NULL };
+  uint8_t sections, page;
+  uint16_t len;
+  int i, j;
+
+  if(query_len != QUERY_LEN || query[0] != 'S' || query[1] != ATTEST_STATS_VERSION ||
+     query[2] != 'q' || size < ATTEST_STATS_BUF_LEN) {
+    return 0;
+  }
+  sections = query[3] & ATTEST_STATS_SECTION_ALL;
+  page = query[5];
+  pg.want = page;
+  if(page == 0) {
+    counters[ATTEST_STAT_QUERIES]++;
+  }
+
+  // The gauges of the other modules are read now
+  gauges[ATTEST_GAUGE_REGISTRY] = attest_registry_count();
+  gauges[ATTEST_GAUGE_QUARANTINE] = attest_quarantine_count();
+
+  // The whole body is built after the header and cut in pages of whole values, then the page is
+  // moved in place
+  *p++ = stats_role;
+  p = put16(p, node_id);
+  p = put32(p, (uint32_t)(clock_time() / CLOCK_SECOND));
+  page_value(&pg, p);
+  if(sections & ATTEST_STATS_SECTION_COUNTERS) {
+    *p++ = ATTEST_STAT_COUNT;
+    page_value(&pg, p);
+    for(i = 0; i < ATTEST_STAT_COUNT; i++) {
+      p = put32(p, counters[i]);
+      page_value(&pg, p);
+    }
+  }
+  if(sections & ATTEST_STATS_SECTION_GAUGES) {
+    *p++ = ATTEST_GAUGE_COUNT;
+    page_value(&pg, p);
+    for(i = 0; i < ATTEST_GAUGE_COUNT; i++) {
+      p = put16(p, gauges[i]);
+      page_value(&pg, p);
+    }
+  }
+  if(sections & ATTEST_STATS_SECTION_HISTOGRAMS) {
+    *p++ = ATTEST_HIST_COUNT;
+    *p++ = ATTEST_HIST_BUCKETS;
+    page_value(&pg, p);
+    for(i = 0; i < ATTEST_HIST_COUNT; i++) {
+      for(j = 0; j < ATTEST_HIST_BUCKETS; j++) {
+        p = put16(p, histograms[i][j] > 0xffff ? 0xffff : histograms[i][j]);
+        page_value(&pg, p);
+      }
+    }
+  }
+
+  if(pg.from == NULL) {
+    return 0;
+  }
+  len = pg.to - pg.from;
+  memmove(buf + ATTEST_STATS_HEADER_LEN, pg.from, len);
+  buf[0] = 'S';
+  buf[1] = ATTEST_STATS_VERSION;
+  buf[2] = 'r';
+  buf[3] = sections;
+  buf[4] = page;
+  buf[5] = pg.page + 1;
+
+#if ATTEST_STATS_RESET
+  // The counters and the histograms start again from zero once the last page is sent, the gauges
+  // are current values
+  if((query[4] & ATTEST_STATS_FLAG_RESET) && page == pg.page) {
+    memset(counters, 0, sizeof(counters));
+    memset(histograms, 0, sizeof(histograms));
+  }
+#endif
+  return ATTEST_STATS_HEADER_LEN + len;
+}
+
+void
+attest_stats_query(const uip_ipaddr_t *addr, uint8_t sections, uint8_t flags, uint8_t page)
+{
+  uint8_t query[QUERY_LEN] = { 'S', ATTEST_STATS_VERSION, 'q', sections, flags, page };
+  simple_udp_sendto_port(&stats_conn, query, sizeof(query), addr, UDP_STATS_PORT);
+}
+
+// Print a response in hex, one line per response
+static void
+print_response(const uip_ipaddr_t *sender_addr, const uint8_t *data, uint16_t datalen)
+{
+  static const char digits[] = "0123456789abcdef";
+  static char hex[2 * RESPONSE_MAX_LEN + 1];
+  uint16_t i;
+
+  if(datalen > RESPONSE_MAX_LEN) {
+    datalen = RESPONSE_MAX_LEN;
+  }
+  for(i = 0; i < datalen; i++) {
+    hex[2 * i] = digits[data[i] >> 4];
+    hex[2 * i + 1] = digits[data[i] & 0x0f];
+  }
+  hex[2 * datalen] = '\0';
+  LOG_INFO("Stats of IP: '");
+  LOG_INFO_6ADDR(sender_addr);
+  LOG_INFO_("' %s\n", hex);
+}
+
+// Call back function. This function answers the queries and prints the responses
+static void
+stats_rx_callback(struct simple_udp_connection *c,
+                  const uip_ipaddr_t *sender_addr,
+                  uint16_t sender_port,
+                  const uip_ipaddr_t *receiver_addr,
+                  uint16_t receiver_port,
+                  const uint8_t *data,
+                  uint16_t datalen)
+{
+  static uint8_t response[ATTEST_STATS_BUF_LEN];
+  uint16_t len;
+
+  if(datalen >= ATTEST_STATS_HEADER_LEN && data[0] == 'S' && data[2] == 'r') {
+    print_response(sender_addr, data, datalen);
+#if ATTEST_STATS_POLL
+    // Ask the polled mote for its next page
+    if(data[1] == ATTEST_STATS_VERSION && data[4] + 1 < data[5] &&
+       uip_ipaddr_cmp(sender_addr, &sender_addrs[poll_index])) {
+      attest_stats_query(sender_addr, data[3], 0, data[4] + 1);
+    }
+#endif
+    return;
+  }
+  len = attest_stats_response(data, datalen, response, sizeof(response));
+  if(len == 0) {
+    LOG_WARN("Dropping an invalid stats query from IP: '");
+    LOG_WARN_6ADDR(sender_addr);
+    LOG_WARN_("'\n");
+    return;
+  }
+  // The connection accepts any source port, the answer goes back to the port of the query
+  simple_udp_sendto_port(&stats_conn, response, len, sender_addr, sender_port);
+}
+
+#if ATTEST_STATS_POLL
+// Server side: query the next known mote
+static void
+poll_next(void *ptr)
+{
+  int i;
+  for(i = 0; i < MAX_NODES; i++) {
+    poll_index = (poll_index + 1) % MAX_NODES;
+    if(sender_ports[poll_index] != 0) {
+      attest_stats_query(&sender_addrs[poll_index], ATTEST_STATS_SECTION_ALL, 0, 0);
+      break;
+    }
+  }
+  ctimer_reset(&poll_timer);
+}
+#endif /* ATTEST_STATS_POLL */
+
+void
+attest_stats_init(uint8_t role)
+{
+  stats_role = role;
+  // The remote port 0 accepts the queries of the host tools, they are sent from any port
+  simple_udp_register(&stats_conn, UDP_STATS_PORT, NULL, 0, stats_rx_callback);
+#if ATTEST_STATS_POLL
+  if(role == ATTEST_STATS_ROLE_SERVER) {
+    ctimer_set(&poll_timer, ATTEST_STATS_POLL, poll_next, NULL);
+  }
+#endif
+}
+/*------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,163 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Runtime statistics of a mote, in every role. The functionality is:
+// * Fixed size counters (ATTEST_STAT_*), gauges (ATTEST_GAUGE_*) and histograms with power of two
+//   buckets (ATTEST_HIST_*): bucket 0 counts the value 0 and bucket b the values from 2^(b-1) to
+//   2^b - 1, the last bucket also counts the larger values.
+// * Every mote answers a binary query on UDP_STATS_PORT from any source port, so the server
+//   (ATTEST_CONF_STATS_POLL) or a host tool (tools/stats-query.py) can pull the statistics of any
+//   mote on demand. All the values are in network byte order:
+//     query     'S' <version> 'q' <sections> <flags> <page>
+//     response  'S' <version> 'r' <sections> <page> <pages> <at most ATTEST_STATS_PAGE_LEN bytes>
+//   The pages are the consecutive parts of the body, cut between two values:
+//               <role> <node id, 2> <uptime s, 4>
+//               [counters]    <n> <n values, 4 bytes each>
+//               [gauges]      <n> <n values, 2 bytes each>
+//               [histograms]  <n> <buckets> <n * buckets values, 2 bytes each, saturated>
+//   The sections are a mask of ATTEST_STATS_SECTION_*. A response fits in one IEEE 802.15.4 frame,
+//   so a query of 6 bytes never triggers a fragmented answer. The body is built again for every
+//   query, the pages of one body can come from slightly different times. A page ends on a whole
+//   value, so every value is from one time and the joined pages always decode.
+// * The queries are not authenticated. The flag ATTEST_STATS_FLAG_RESET, which clears the counters
+//   and the histograms once the last page is sent, is ignored unless the firmware is built with
+//   ATTEST_CONF_STATS_RESET=1, for test networks only.
+// * The server polls its known motes one after the other every ATTEST_STATS_POLL when it is set,
+//   it asks for the next page when a page arrives and prints the pages in hex ("Stats of IP: '<ip>'
+//   <hex>"), tools/stats-query.py joins and decodes them from the mote output.
+//
+// The hourly report (attest-report.h) reads its values from the same counters.
+
+#ifndef ATTEST_STATS_H_
+#define ATTEST_STATS_H_
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------- Imports of the libraries -------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/simple-udp.h"
+#include <stdint.h>
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Initialize ----------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Initialize the counters, the order is the order of the response (see tools/stats-query.py)
+#define ATTEST_STAT_RX                   0  // messages received on the attestation port
+#define ATTEST_STAT_RX_DROPPED           1  // malformed messages dropped by the parser
+#define ATTEST_STAT_VERIFIED             2  // messages with a verified key
+#define ATTEST_STAT_REJECTED             3  // messages with a rejected key
+#define ATTEST_STAT_ENROLLED             4  // motes added to the registry
+#define ATTEST_STAT_REGISTRY_FULL        5  // messages of motes that did not fit in the registry
+#define ATTEST_STAT_TX                   6  // messages sent on the attestation port
+#define ATTEST_STAT_TX_BYTES             7  // bytes of the messages sent
+#define ATTEST_STAT_CHALLENGES           8  // challenges sent (server) or answered (client)
+#define ATTEST_STAT_COMPLETED            9  // attestations completed (server)
+#define ATTEST_STAT_EXPIRED             10  // requests to validate not answered in time (server)
+#define ATTEST_STAT_MISSED              11  // hellos not answered by the server (client)
+#define ATTEST_STAT_REDIRECTS           12  // "moved" messages sent (server) or received (client)
+#define ATTEST_STAT_QUARANTINED         13  // motes put in quarantine (server)
+#define ATTEST_STAT_QUARANTINE_DROPPED  14  // packets dropped by the quarantine
+#define ATTEST_STAT_QUERIES             15  // statistics queries answered
+#define ATTEST_STAT_QUARANTINE_FULL     16  // rejected motes not stored, the list was full (server)
+#define ATTEST_STAT_COUNT               17
+
+// Initialize the gauges, the registry and the quarantine are read when the response is built
+#define ATTEST_GAUGE_REGISTRY    0  // motes in the registry
+#define ATTEST_GAUGE_CHALLENGES  1  // requests to validate waiting for an answer (server)
+#define ATTEST_GAUGE_QUARANTINE  2  // motes in the quarantine list
+#define ATTEST_GAUGE_COUNT       3
+
+// Initialize the histograms
+#define ATTEST_HIST_CALLBACK_TICKS  0  // execution time of the receive callback in rtimer ticks
+#define ATTEST_HIST_TX_BYTES        1  // size of the messages sent
+#define ATTEST_HIST_ATTEST_MS       2  // time to complete an attestation in ms (server)
+#define ATTEST_HIST_COUNT           3
+#define ATTEST_HIST_BUCKETS        16
+
+// Initialize the role of the mote in the response
+#define ATTEST_STATS_ROLE_SERVER     0
+#define ATTEST_STATS_ROLE_CLIENT     1
+#define ATTEST_STATS_ROLE_MALICIOUS  2
+
+// Initialize the sections and the flags of a query
+#define ATTEST_STATS_SECTION_COUNTERS   0x01
+#define ATTEST_STATS_SECTION_GAUGES     0x02
+#define ATTEST_STATS_SECTION_HISTOGRAMS 0x04
+#define ATTEST_STATS_SECTION_ALL        0x07
+#define ATTEST_STATS_FLAG_RESET         0x01
+
+// Initialize the length of the header of a response, of the longest body and of the buffer of
+// attest_stats_response
+#define ATTEST_STATS_HEADER_LEN 6
+#define ATTEST_STATS_BODY_MAX   (7 + 1 + 4 * ATTEST_STAT_COUNT + 1 + 2 * ATTEST_GAUGE_COUNT + \
+                                 2 + 2 * ATTEST_HIST_COUNT * ATTEST_HIST_BUCKETS)
+#define ATTEST_STATS_BUF_LEN    (ATTEST_STATS_HEADER_LEN + ATTEST_STATS_BODY_MAX)
+
+// Initialize the version of the messages and the port
+#define ATTEST_STATS_VERSION 2
+#define UDP_STATS_PORT 5681
+
+// Initialize the maximum length of the part of the body in a response, with the 6 bytes of the
+// header the response fits in one frame with the compressed IPv6, UDP and RPL headers
+#ifdef ATTEST_CONF_STATS_PAGE_LEN
+#define ATTEST_STATS_PAGE_LEN ATTEST_CONF_STATS_PAGE_LEN
+#else
+#define ATTEST_STATS_PAGE_LEN 48
+#endif
+
+// Initialize the support of ATTEST_STATS_FLAG_RESET, 0 ignores the flag
+#ifdef ATTEST_CONF_STATS_RESET
+#define ATTEST_STATS_RESET ATTEST_CONF_STATS_RESET
+#else
+#define ATTEST_STATS_RESET 0
+#endif
+
+// Initialize the interval at which the server polls one of its motes, 0 disables the polling
+#ifdef ATTEST_CONF_STATS_POLL
+#define ATTEST_STATS_POLL ATTEST_CONF_STATS_POLL
+#else
+#define ATTEST_STATS_POLL 0
+#endif
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- Functions ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Start the statistics and answer the queries. It has to be called from the main process of every
+// mote with its ATTEST_STATS_ROLE_*, the server also starts the polling
+void attest_stats_init(uint8_t role);
+
+// Add to a counter
+void attest_stats_add(uint8_t counter, uint32_t value);
+#define attest_stats_inc(counter) attest_stats_add(counter, 1)
+
+// Returns the value of a counter
+uint32_t attest_stats_get(uint8_t counter);
+
+// Set a gauge
+void attest_stats_set_gauge(uint8_t gauge, uint16_t value);
+
+// Count a value in a histogram
+void attest_stats_record(uint8_t hist, uint32_t value);
+
+// Send a message of the attestation protocol and count it (ATTEST_STAT_TX, ATTEST_STAT_TX_BYTES,
+// ATTEST_HIST_TX_BYTES)
+int attest_stats_sendto(struct simple_udp_connection *c, const void *data, uint16_t datalen,
+                        const uip_ipaddr_t *to);
+
+// Build the response to a query into buf, returns its length or 0 if the query is not valid. The
+// whole body is built in buf, it needs ATTEST_STATS_BUF_LEN bytes
+uint16_t attest_stats_response(const uint8_t *query, uint16_t query_len, uint8_t *buf,
+                               uint16_t size);
+
+// Send a query for a page to the mote with the given address, the response is printed by the server
+void attest_stats_query(const uip_ipaddr_t *addr, uint8_t sections, uint8_t flags,
+                        uint8_t page);
+
+#endif /* ATTEST_STATS_H_ */
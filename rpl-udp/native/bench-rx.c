@@ -0,0 +1,225 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Microbenchmark of the receive path of the firmware (see rx-driver.h for the firmware under test).
+// Every case delivers the same payload to the receive callback in a loop, the number of iterations
+// is doubled until the case runs for at least the minimum time. The output follows the format of
+// Google Benchmark, one line per case named <firmware>/<message>/<payload size>:
+//   Benchmark                      Time        CPU   Iterations  tx_bytes
+//   server/hello/19             85.2 ns    85.1 ns      8388608        19
+// Time is the wall time and CPU the process time per message, tx_bytes the bytes sent in reply to
+// one message. The realistic messages are followed by adversarial ones that the parser rejects or
+// that make it do the most work.
+//
+// Usage: ./bench-server [--filter <substring>] [--min-time <seconds>]
+
+#include "rx-driver.h"
+#include "contiki.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+extern unsigned long native_tx_bytes;
+
+// Key of the enrolled sender 0 and the key of no one
+#define BENCH_KEY   "benchkey01"
+#define OTHER_KEY   "otherkey99"
+
+// Keys longer and shorter than the key of the server, the body of the hello is moved in the reply
+#define LONG_KEY    "benchkey0123456"
+#define SHORT_KEY   "bk1"
+
+// IPHC header with all the fields elided, the NHC UDP header, the ports 5678 and 8765 and the NHC
+// hop-by-hop header with the RPL option
+#define IPHC        "\x7e\x33"
+#define IPHC_NHC    IPHC "\xf0"
+#define UDP_PORTS   "\x16\x2e\x22\x3d"
+#define RPL_HBH     "\xe1\x06\x63\x04\x01\x01\x01\x01"
+
+// A benchmark case, the payload is built from the pattern: the text is followed by the filler
+// repeated up to the given size. The quarantine frames are built from their number of IDs instead,
+// a negative number gives the IDs in the wrong order. The sender is enrolled with the key of the
+// case, BENCH_KEY when it is not given
+struct bench_case {
+  const char *role;
+  const char *name;
+  const char *text;
+  const char *filler;
+  uint16_t size;
+  int16_t ids;
+  const char *key;
+};
+
+static const struct bench_case cases[] = {
+  // Messages of the clients to the server
+  { "server", "hello",          BENCH_KEY " hello 12",                 NULL,  0, 0, NULL },
+  { "server", "hello",          BENCH_KEY " hello 12 ",                "x",  64, 0, NULL },
+  { "server", "hello",          BENCH_KEY " hello 12 ",                "x", 120, 0, NULL },
+  { "server", "hello+attest",   BENCH_KEY " hello 12 attest",          NULL,  0, 0, NULL },
+  { "server", "attest",         BENCH_KEY " attest",                   NULL,  0, 0, NULL },
+  { "server", "quarantined",    OTHER_KEY " hello 12",                 NULL,  0, 0, NULL },
+  // Messages of the server to the clients
+  { "client", "echo",           BENCH_KEY " hello 12",                 NULL,  0, 0, NULL },
+  { "client", "echo",           BENCH_KEY " hello 12 ",                "x", 120, 0, NULL },
+  { "client", "echo+validate",  BENCH_KEY " hello 12 validate",        NULL,  0, 0, NULL },
+  { "client", "validate",       BENCH_KEY " validate ",                NULL,  0, 0, NULL },
+  { "client", "moved",          BENCH_KEY " moved 1",                  NULL,  0, 0, NULL },
+  { "client", "rejected",       OTHER_KEY " hello 12",                 NULL,  0, 0, NULL },
+  // Messages of the clients to the server, in the packet buffer where the reply is built: the
+  // body is in place with a key of the length of the key of the server, it is moved otherwise
+  { "inplace", "hello",         BENCH_KEY " hello 12",                 NULL,  0, 0, NULL },
+  { "inplace", "hello",         BENCH_KEY " hello 12 ",                "x", 120, 0, NULL },
+  { "inplace", "hello-long-key", LONG_KEY " hello 12 ",                "x", 120, 0, LONG_KEY },
+  { "inplace", "hello-short-key", SHORT_KEY " hello 12 ",              "x", 120, 0, SHORT_KEY },
+  // Quarantine frames of the neighbours, already known after the first one
+  { "quarantine", "frame",      NULL,                                  NULL,  0,   1, NULL },
+  { "quarantine", "frame",      NULL,                                  NULL,  0,   8, NULL },
+  { "quarantine", "frame",      NULL,                                  NULL,  0,  32, NULL },
+  { "quarantine", "unsorted",   NULL,                                  NULL,  0, -32, NULL },
+  // Statistics queries of the server or of the host tool for their last page, and a page of a
+  // response printed in hex. The strings end at a zero byte, the pages and the flags are not zero
+  { "stats",  "query-counters", "S\x02q\x01\x02\x01",                  NULL,  0, 0, NULL },
+  { "stats",  "query-all",      "S\x02q\x07\x02\x03",                  NULL,  0, 0, NULL },
+  { "stats",  "response",       "S\x02r\x07\x01\x04",                  "\x55", 54, 0, NULL },
+  // Compressed frames of the TSCH scheduler: UDP compressed with NHC, after a fragment header,
+  // after the RPL hop-by-hop option and not compressed
+  { "iphc",   "udp",            IPHC_NHC UDP_PORTS "\x12\x34" "key hello 1", NULL,  0, 0, NULL },
+  { "iphc",   "frag1",          "\xc1\x01\x01\x01" IPHC_NHC UDP_PORTS,      NULL,  0, 0, NULL },
+  { "iphc",   "hop-by-hop",     IPHC RPL_HBH "\xf0" UDP_PORTS,                 NULL,  0, 0, NULL },
+  { "iphc",   "inline-udp",     "\x7a\x33\x11" UDP_PORTS,                     NULL,  0, 0, NULL },
+  // Adversarial messages, for all the receive paths
+  { NULL,     "long-key",       "",                                    "k", 120, 0, NULL },
+  { NULL,     "many-items",     BENCH_KEY,                             " a", 120, 0, NULL },
+  { NULL,     "spaces",         BENCH_KEY,                             " ", 120, 0, NULL },
+  { NULL,     "bad-char",       BENCH_KEY " hello ",                   "\x01", 120, 0, NULL },
+  { NULL,     "too-long",       BENCH_KEY " hello 12 ",                "x", 1200, 0, NULL },
+  { NULL,     "empty",          "",                                    NULL,  0, 0, NULL },
+};
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- Functions ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Returns the time of the given clock in nanoseconds
+static double
+now_ns(clockid_t clock)
+{
+  struct timespec ts;
+  clock_gettime(clock, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Build a quarantine frame with the given number of IDs, see attest-quarantine.h
+static uint16_t
+build_frame(int16_t ids, uint8_t **payload)
+{
+  uint16_t n = ids < 0 ? -ids : ids;
+  uint16_t size = 2 + 2 * n;
+  uint16_t i, id;
+
+  *payload = malloc(size);
+  (*payload)[0] = 'Q';
+  (*payload)[1] = n;
+  for(i = 0; i < n; i++) {
+    id = ids < 0 ? 1000 - 3 * i : 100 + 3 * i;
+    (*payload)[2 + 2 * i] = id >> 8;
+    (*payload)[3 + 2 * i] = id & 0xff;
+  }
+  return size;
+}
+
+// Build the payload of a case into a buffer of its exact size, returns the size
+static uint16_t
+build_payload(const struct bench_case *c, uint8_t **payload)
+{
+  if(c->text == NULL) {
+    return build_frame(c->ids, payload);
+  }
+  uint16_t len = strlen(c->text);
+  uint16_t size = c->size > len ? c->size : len;
+  uint16_t flen = c->filler ? strlen(c->filler) : 0;
+
+  *payload = malloc(size ? size : 1);
+  memcpy(*payload, c->text, len);
+  while(len < size) {
+    (*payload)[len] = c->filler[(len - strlen(c->text)) % flen];
+    len++;
+  }
+  return size;
+}
+
+// Run one case and print its line
+static void
+run_case(const struct bench_case *c, double min_time)
+{
+  uint8_t *payload;
+  uint16_t size = build_payload(c, &payload);
+  unsigned long iterations, i, tx_bytes;
+  double wall, cpu;
+
+  // Enroll the sender 0 and bring the firmware to its steady state with one message
+  rx_reset();
+  rx_enroll(0, c->key ? c->key : BENCH_KEY);
+  rx_receive(0, payload, size);
+
+  for(iterations = 64;; iterations *= 2) {
+    tx_bytes = native_tx_bytes;
+    wall = now_ns(CLOCK_MONOTONIC);
+    cpu = now_ns(CLOCK_PROCESS_CPUTIME_ID);
+    for(i = 0; i < iterations; i++) {
+      rx_receive(0, payload, size);
+    }
+    wall = now_ns(CLOCK_MONOTONIC) - wall;
+    cpu = now_ns(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+    if(wall >= min_time * 1e9 || iterations >= (1UL << 30)) {
+      break;
+    }
+  }
+  tx_bytes = native_tx_bytes - tx_bytes;
+
+  printf("%s/%s/%-*u %9.1f ns %9.1f ns %12lu %9lu\n", rx_role, c->name,
+         (int)(24 - strlen(rx_role) - strlen(c->name)), size, wall / iterations,
+         cpu / iterations, iterations, tx_bytes / iterations);
+  free(payload);
+}
+
+int
+main(int argc, char **argv)
+{
+  const char *filter = NULL;
+  double min_time = 0.2;
+  char name[64];
+  size_t i;
+  int a;
+
+  for(a = 1; a < argc; a++) {
+    if(strcmp(argv[a], "--filter") == 0 && a + 1 < argc) {
+      filter = argv[++a];
+    }
+    else if(strcmp(argv[a], "--min-time") == 0 && a + 1 < argc) {
+      min_time = atof(argv[++a]);
+    }
+    else {
+      fprintf(stderr, "Usage: %s [--filter <substring>] [--min-time <seconds>]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  printf("%-30s %12s %12s %12s %9s\n", "Benchmark", "Time", "CPU", "Iterations", "tx_bytes");
+  for(i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    if(cases[i].role != NULL && strcmp(cases[i].role, rx_role) != 0) {
+      continue;
+    }
+    snprintf(name, sizeof(name), "%s/%s", rx_role, cases[i].name);
+    if(filter != NULL && strstr(name, filter) == NULL) {
+      continue;
+    }
+    run_case(&cases[i], min_time);
+  }
+  return 0;
+}
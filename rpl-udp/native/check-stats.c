@@ -0,0 +1,133 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Check of the pages of the statistics responses (attest-stats.c). The pages of one response are
+// fetched by separate queries, the values change between two queries like on a running mote. Every
+// value of the joined body has to be a whole value of one of the two states, a value split between
+// two pages would mix the bytes of both. The counters and the histograms are filled with patterns
+// whose bytes all differ between the two states, so a split value is always detected.
+//
+// Usage: ./check-stats, the exit code is 0 when every check passes
+
+#include "../attest-stats.c"
+#include "sys/node-id.h"
+#include <stdio.h>
+
+// Initialize the patterns of the two states, the low bits are the index of the value
+#define COUNTER_BEFORE 0x11111100UL
+#define COUNTER_AFTER  0x22222280UL
+#define HIST_BEFORE    0x1100
+#define HIST_AFTER     0x2280
+
+static int failures;
+
+// Fill the counters and the histograms with the pattern of a state
+static void
+fill(int after)
+{
+  int i, j;
+  for(i = 0; i < ATTEST_STAT_COUNT; i++) {
+    counters[i] = (after ? COUNTER_AFTER : COUNTER_BEFORE) | i;
+  }
+  for(i = 0; i < ATTEST_HIST_COUNT; i++) {
+    for(j = 0; j < ATTEST_HIST_BUCKETS; j++) {
+      histograms[i][j] = (after ? HIST_AFTER : HIST_BEFORE) | (i * ATTEST_HIST_BUCKETS + j);
+    }
+  }
+}
+
+static void
+fail(const char *what, unsigned index, unsigned long value)
+{
+  fprintf(stderr, "check-stats: %s %u has the value 0x%lx of no state\n", what, index, value);
+  failures++;
+}
+
+// Fetch every page of a response for the sections, the state changes after every page. Returns the
+// length of the joined body
+static uint16_t
+fetch(uint8_t sections, uint8_t *body)
+{
+  uint8_t query[QUERY_LEN] = { 'S', ATTEST_STATS_VERSION, 'q', sections, 0, 0 };
+  static uint8_t buf[ATTEST_STATS_BUF_LEN];
+  uint16_t len = 0, n;
+  uint8_t page;
+
+  for(page = 0;; page++) {
+    fill(page & 1);
+    query[5] = page;
+    n = attest_stats_response(query, sizeof(query), buf, sizeof(buf));
+    if(n == 0) {
+      fprintf(stderr, "check-stats: page %u is missing\n", page);
+      failures++;
+      return len;
+    }
+    if(n > ATTEST_STATS_HEADER_LEN + ATTEST_STATS_PAGE_LEN || buf[4] != page) {
+      fprintf(stderr, "check-stats: page %u has %u bytes\n", page, n);
+      failures++;
+    }
+    memcpy(body + len, buf + ATTEST_STATS_HEADER_LEN, n - ATTEST_STATS_HEADER_LEN);
+    len += n - ATTEST_STATS_HEADER_LEN;
+    if(page + 1 >= buf[5]) {
+      return len;
+    }
+  }
+}
+
+// Decode a joined body like tools/stats-query.py and check every counter and histogram value
+static void
+check(uint8_t sections, const uint8_t *body, uint16_t len)
+{
+  uint16_t p = 7, i, n, v;
+  uint32_t c;
+
+  if(sections & ATTEST_STATS_SECTION_COUNTERS) {
+    n = body[p++];
+    for(i = 0; i < n && p + 4 <= len; i++, p += 4) {
+      c = ((uint32_t)body[p] << 24) | ((uint32_t)body[p + 1] << 16) | (body[p + 2] << 8) |
+          body[p + 3];
+      // The queries are counted by the response itself
+      if(i != ATTEST_STAT_QUERIES && c != (COUNTER_BEFORE | i) && c != (COUNTER_AFTER | i)) {
+        fail("counter", i, c);
+      }
+    }
+  }
+  if(sections & ATTEST_STATS_SECTION_GAUGES) {
+    n = body[p++];
+    p += 2 * n;
+  }
+  if(sections & ATTEST_STATS_SECTION_HISTOGRAMS) {
+    n = body[p] * body[p + 1];
+    p += 2;
+    for(i = 0; i < n && p + 2 <= len; i++, p += 2) {
+      v = (body[p] << 8) | body[p + 1];
+      if(v != (HIST_BEFORE | i) && v != (HIST_AFTER | i)) {
+        fail("histogram value", i, v);
+      }
+    }
+  }
+  if(p != len) {
+    fprintf(stderr, "check-stats: body of %u bytes, %u decoded\n", len, p);
+    failures++;
+  }
+}
+
+int
+main(void)
+{
+  static uint8_t body[ATTEST_STATS_BODY_MAX];
+  uint8_t sections;
+  uint16_t len;
+
+  node_id = 1;
+  attest_stats_init(ATTEST_STATS_ROLE_SERVER);
+  for(sections = 1; sections <= ATTEST_STATS_SECTION_ALL; sections++) {
+    len = fetch(sections, body);
+    check(sections, body, len);
+  }
+  fprintf(stderr, "check-stats: %d failures\n", failures);
+  return failures != 0;
+}
@@ -0,0 +1,92 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Fuzz target of the receive path of the firmware (see rx-driver.h for the firmware under test).
+// The first byte of an input selects the sender (low 4 bits), empties the registry (bit 4) and
+// advances the clock by up to 70 s (bits 5 to 7) and runs the callback timers so that the deadlines
+// and the periodic messages are reached. The other bytes are the payload, passed in a buffer of
+// their exact size.
+//
+// Built with -DRX_LIBFUZZER the file is a libFuzzer target (clang -fsanitize=fuzzer). Otherwise it
+// has a main that runs every file given as argument, or the standard input when there is none, so
+// the same binary is used by AFL (afl-gcc, "afl-fuzz -i corpus -o findings ./fuzz-server") and to
+// replay a corpus or a crash.
+
+#include "rx-driver.h"
+#include "contiki.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern int native_log_enabled;
+
+int
+LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+  uint8_t *payload;
+  uint16_t len;
+
+  if(size == 0) {
+    return 0;
+  }
+  // Format the logs so that their arguments are checked on the fuzzed data as well
+  native_log_enabled = 1;
+
+  if(data[0] & 0x10) {
+    rx_reset();
+  }
+  native_clock += (clock_time_t)(data[0] >> 5) * 10 * CLOCK_SECOND;
+  native_timers_run();
+
+  len = size - 1 > 0xffff ? 0xffff : (uint16_t)(size - 1);
+  payload = malloc(len ? len : 1);
+  if(payload == NULL) {
+    return 0;
+  }
+  memcpy(payload, data + 1, len);
+  rx_receive(data[0] & 0x0f, payload, len);
+  free(payload);
+  return 0;
+}
+
+#ifndef RX_LIBFUZZER
+// Read a whole file, the input is limited to 64 KiB like the uIP datagrams
+static size_t
+read_input(FILE *f, uint8_t *buf, size_t size)
+{
+  size_t len = 0, n;
+  while(len < size && (n = fread(buf + len, 1, size - len, f)) > 0) {
+    len += n;
+  }
+  return len;
+}
+
+int
+main(int argc, char **argv)
+{
+  static uint8_t buf[0x10000];
+  FILE *f;
+  int i;
+
+  rx_reset();
+  if(argc < 2) {
+    LLVMFuzzerTestOneInput(buf, read_input(stdin, buf, sizeof(buf)));
+    return 0;
+  }
+  for(i = 1; i < argc; i++) {
+    f = fopen(argv[i], "rb");
+    if(f == NULL) {
+      fprintf(stderr, "Cannot open %s\n", argv[i]);
+      return 1;
+    }
+    LLVMFuzzerTestOneInput(buf, read_input(f, buf, sizeof(buf)));
+    fclose(f);
+  }
+  fprintf(stderr, "%s: %d inputs run\n", rx_role, argc - 1);
+  return 0;
+}
+#endif
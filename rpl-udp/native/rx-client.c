@@ -0,0 +1,87 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Driver of the receive path of the client firmware. The sender 0 is the server (mote ID 1), the
+// other senders are the motes with ID 2 to 16. The client under test is the mote CLIENT_ID, its
+// node ID, link-layer address and IPv6 address are built like the Cooja motes.
+
+#include "../udp-client.c"
+#include "rx-driver.h"
+#include "net/ipv6/uip-ds6.h"
+#include "sys/node-id.h"
+#include "net/netstack.h"
+
+const char rx_role[] = "client";
+
+// Initialize the mote ID of the client under test, after the server and the senders
+#define CLIENT_ID 20
+
+// Returns the link-layer address of a mote, built like the Cooja motes from the mote ID
+static void
+mote_lladdr(uint16_t id, uip_lladdr_t *lladdr)
+{
+  int i;
+  for(i = 0; i < 8; i += 2) {
+    lladdr->addr[i] = id >> 8;
+    lladdr->addr[i + 1] = id & 0xff;
+  }
+}
+
+// Returns the global address of a mote
+static void
+mote_addr(uint16_t id, uip_ipaddr_t *addr)
+{
+  uip_lladdr_t lladdr;
+  mote_lladdr(id, &lladdr);
+  uip_ip6addr(addr, UIP_DS6_DEFAULT_PREFIX, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(addr, &lladdr);
+}
+
+// Returns the address of a sender
+static void
+sender_addr(uint8_t sender, uip_ipaddr_t *addr)
+{
+  mote_addr((sender & 0x0f) + 1, addr);
+}
+
+void
+rx_reset(void)
+{
+  int i;
+  node_id = CLIENT_ID;
+  mote_lladdr(CLIENT_ID, &uip_lladdr);
+  attest_quarantine_init();
+  for(i = 0; i < MAX_NODES; i++) {
+    attest_registry_remove(i);
+  }
+  validate = false;
+  attest_pending = false;
+}
+
+void
+rx_receive(uint8_t sender, const uint8_t *data, uint16_t datalen)
+{
+  uip_ipaddr_t from, to;
+  sender_addr(sender, &from);
+  mote_addr(CLIENT_ID, &to);
+  // The packet goes through the IP packet processors first, like in uIP. Like simple-udp the
+  // callback gets the addresses in the IP header of the packet buffer
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &from);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &to);
+  if(native_ip_input() == NETSTACK_IP_DROP) {
+    return;
+  }
+  udp_rx_callback(&udp_conn, &UIP_IP_BUF->srcipaddr, UDP_SERVER_PORT,
+                  &UIP_IP_BUF->destipaddr, UDP_CLIENT_PORT, data, datalen);
+}
+
+void
+rx_enroll(uint8_t sender, const char *key)
+{
+  char hello[64];
+  int len = snprintf(hello, sizeof(hello), "%s hello 0", key);
+  rx_receive(sender, (const uint8_t *)hello, (uint16_t)len);
+}
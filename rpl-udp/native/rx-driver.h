@@ -0,0 +1,30 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Driver of the receive path of one firmware. The driver includes the firmware source, so the
+// callback that is run is the real udp_rx_callback of udp-server.c (rx-server.c) or udp-client.c
+// (rx-client.c) compiled against the native stand-ins of the Contiki headers (stubs/).
+
+#ifndef RX_DRIVER_H_
+#define RX_DRIVER_H_
+
+#include <stdint.h>
+
+// Name of the firmware or module of the driver, "server", "client", "quarantine", "stats" or
+// "iphc"
+extern const char rx_role[];
+
+// Empty the registry and the state of the firmware
+void rx_reset(void);
+
+// Deliver a message to the receive callback of the firmware. The sender is one of 16 motes, the
+// data is passed as it is so that the sanitizers see its exact size
+void rx_receive(uint8_t sender, const uint8_t *data, uint16_t datalen);
+
+// Store the sender with the given key, its following messages with the same key are verified
+void rx_enroll(uint8_t sender, const char *key);
+
+#endif /* RX_DRIVER_H_ */
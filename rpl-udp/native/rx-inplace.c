@@ -0,0 +1,15 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Driver of the receive path of the server firmware with the message in the packet buffer, at
+// UIP_IPUDPH_LEN where the reply is built. simple-udp passes a copy of the payload to the callback,
+// so on the motes the body is always moved from that copy. Here the body overlaps the reply and
+// attest_msg_build_reply moves it inside the packet buffer, or leaves it in place when the keys of
+// the sender and of the server have the same length. The sanitizers see the size of the packet
+// buffer instead of the exact size of the message, rx-server.c covers that.
+
+#define RX_IN_PACKET_BUFFER 1
+#include "rx-server.c"
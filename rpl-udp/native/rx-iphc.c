@@ -0,0 +1,37 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Driver of the classifier of the compressed 6LoWPAN frames (attest-iphc.c) used by the TSCH
+// scheduler. The data is the frame as it is in the MAC layer, the sender is not used.
+
+#include "../attest-iphc.c"
+#include "rx-driver.h"
+
+const char rx_role[] = "iphc";
+
+// Keep the result so that the classification is not optimized away in the benchmark
+volatile uint16_t rx_iphc_ports;
+
+void
+rx_reset(void)
+{
+  rx_iphc_ports = 0;
+}
+
+void
+rx_receive(uint8_t sender, const uint8_t *data, uint16_t datalen)
+{
+  uint16_t src_port, dst_port;
+  if(attest_iphc_udp_ports(data, datalen, &src_port, &dst_port)) {
+    rx_iphc_ports = src_port ^ dst_port;
+  }
+}
+
+void
+rx_enroll(uint8_t sender, const char *key)
+{
+  // The frames carry no key
+}
@@ -0,0 +1,58 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Driver of the receive path of the quarantine frames (attest-quarantine.c). The senders are the
+// link-local addresses of the motes with ID 2 to 17, the frames are binary.
+
+#include "../attest-quarantine.c"
+#include "rx-driver.h"
+#include "net/ipv6/uip-ds6.h"
+#include "sys/node-id.h"
+
+const char rx_role[] = "quarantine";
+
+// Returns the link-local address of a sender, built like the Cooja motes from the mote ID
+static void
+sender_addr(uint8_t sender, uip_ipaddr_t *addr)
+{
+  uip_lladdr_t lladdr;
+  uint16_t id = (sender & 0x0f) + 2;
+  int i;
+  for(i = 0; i < 8; i += 2) {
+    lladdr.addr[i] = id >> 8;
+    lladdr.addr[i + 1] = id & 0xff;
+  }
+  uip_ip6addr(addr, 0xfe80, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(addr, &lladdr);
+}
+
+void
+rx_reset(void)
+{
+  node_id = 20;
+  attest_quarantine_init();
+}
+
+void
+rx_receive(uint8_t sender, const uint8_t *data, uint16_t datalen)
+{
+  uip_ipaddr_t from, to;
+  sender_addr(sender, &from);
+  uip_create_linklocal_allnodes_mcast(&to);
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &from);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &to);
+  if(native_ip_input() == NETSTACK_IP_DROP) {
+    return;
+  }
+  quarantine_rx_callback(&quarantine_conn, &from, UDP_QUARANTINE_PORT, &to, UDP_QUARANTINE_PORT,
+                         data, datalen);
+}
+
+void
+rx_enroll(uint8_t sender, const char *key)
+{
+  // The quarantine frames carry no key
+}
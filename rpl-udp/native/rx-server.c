@@ -0,0 +1,81 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Driver of the receive path of the server firmware. The senders are the motes with ID 2 to 17.
+
+#include "../udp-server.c"
+#include "rx-driver.h"
+#include "net/ipv6/uip-ds6.h"
+#include "sys/node-id.h"
+#include "net/netstack.h"
+
+#if RX_IN_PACKET_BUFFER
+const char rx_role[] = "inplace";
+#else
+const char rx_role[] = "server";
+#endif
+
+// Returns the address of a sender, built like the Cooja motes from the mote ID
+static void
+sender_addr(uint8_t sender, uip_ipaddr_t *addr)
+{
+  uip_lladdr_t lladdr;
+  uint16_t id = (sender & 0x0f) + 2;
+  int i;
+  for(i = 0; i < 8; i += 2) {
+    lladdr.addr[i] = id >> 8;
+    lladdr.addr[i + 1] = id & 0xff;
+  }
+  uip_ip6addr(addr, UIP_DS6_DEFAULT_PREFIX, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(addr, &lladdr);
+}
+
+void
+rx_reset(void)
+{
+  int i;
+  node_id = 1;
+  attest_quarantine_init();
+  for(i = 0; i < MAX_NODES; i++) {
+    attest_registry_remove(i);
+    challenge_state[i] = CHALLENGE_NONE;
+  }
+  validate = false;
+  servervalidate = false;
+}
+
+void
+rx_receive(uint8_t sender, const uint8_t *data, uint16_t datalen)
+{
+  uip_ipaddr_t from, to;
+  sender_addr(sender, &from);
+  uip_ip6addr(&to, UIP_DS6_DEFAULT_PREFIX, 0, 0, 0, 0x0201, 1, 1, 1);
+  // The packet goes through the IP packet processors first, like in uIP. Like simple-udp the
+  // callback gets the addresses in the IP header of the packet buffer
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &from);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &to);
+  if(native_ip_input() == NETSTACK_IP_DROP) {
+    return;
+  }
+#if RX_IN_PACKET_BUFFER
+  // The message is where the reply is built, see rx-inplace.c
+  if(datalen > UIP_BUFSIZE - UIP_IPUDPH_LEN) {
+    return;
+  }
+  memmove(&uip_buf[UIP_IPUDPH_LEN], data, datalen);
+  data = &uip_buf[UIP_IPUDPH_LEN];
+#endif
+  udp_rx_callback(&udp_conn, &UIP_IP_BUF->srcipaddr, UDP_CLIENT_PORT,
+                  &UIP_IP_BUF->destipaddr, UDP_SERVER_PORT, data, datalen);
+}
+
+void
+rx_enroll(uint8_t sender, const char *key)
+{
+  char hello[64];
+  int len = snprintf(hello, sizeof(hello), "%s hello 0", key);
+  rx_receive(sender, (const uint8_t *)hello, (uint16_t)len);
+}
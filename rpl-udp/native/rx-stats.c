@@ -0,0 +1,61 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Driver of the receive path of the statistics queries (attest-stats.c). The senders are the motes
+// with ID 2 to 17, the queries and the responses are binary.
+
+#include "../attest-stats.c"
+#include "rx-driver.h"
+#include "net/ipv6/uip-ds6.h"
+#include "sys/node-id.h"
+#include "net/netstack.h"
+
+const char rx_role[] = "stats";
+
+// Returns the address of a sender, built like the Cooja motes from the mote ID
+static void
+sender_addr(uint8_t sender, uip_ipaddr_t *addr)
+{
+  uip_lladdr_t lladdr;
+  uint16_t id = (sender & 0x0f) + 2;
+  int i;
+  for(i = 0; i < 8; i += 2) {
+    lladdr.addr[i] = id >> 8;
+    lladdr.addr[i + 1] = id & 0xff;
+  }
+  uip_ip6addr(addr, UIP_DS6_DEFAULT_PREFIX, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(addr, &lladdr);
+}
+
+void
+rx_reset(void)
+{
+  node_id = 1;
+  attest_stats_init(ATTEST_STATS_ROLE_SERVER);
+  memset(counters, 0, sizeof(counters));
+  memset(gauges, 0, sizeof(gauges));
+  memset(histograms, 0, sizeof(histograms));
+}
+
+void
+rx_receive(uint8_t sender, const uint8_t *data, uint16_t datalen)
+{
+  uip_ipaddr_t from, to;
+  sender_addr(sender, &from);
+  uip_ip6addr(&to, UIP_DS6_DEFAULT_PREFIX, 0, 0, 0, 0x0201, 1, 1, 1);
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &from);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &to);
+  if(native_ip_input() == NETSTACK_IP_DROP) {
+    return;
+  }
+  stats_rx_callback(&stats_conn, &from, 40000 + sender, &to, UDP_STATS_PORT, data, datalen);
+}
+
+void
+rx_enroll(uint8_t sender, const char *key)
+{
+  // The statistics queries carry no key
+}
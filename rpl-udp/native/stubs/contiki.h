@@ -0,0 +1,58 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Native stand-ins of the Contiki headers used by the firmware. They provide only what the receive
+// path of the firmware needs so that the callbacks can be compiled and run on the host by the fuzz
+// and benchmark harness. The processes are compiled but never run.
+
+#ifndef NATIVE_CONTIKI_H_
+#define NATIVE_CONTIKI_H_
+
+#include "project-conf.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// Clock, the time is set by the harness
+typedef unsigned long clock_time_t;
+#define CLOCK_SECOND 1000
+extern clock_time_t native_clock;
+clock_time_t clock_time(void);
+
+// Event timers, they never expire
+struct etimer { clock_time_t start, interval; };
+void etimer_set(struct etimer *et, clock_time_t interval);
+void etimer_reset(struct etimer *et);
+void etimer_stop(struct etimer *et);
+int etimer_expired(struct etimer *et);
+clock_time_t etimer_expiration_time(struct etimer *et);
+
+// The callback timers run from native_timers_run, called by the harness after it moved the clock
+struct ctimer { clock_time_t start, interval; void (*f)(void *); void *ptr; int active; };
+void ctimer_set(struct ctimer *c, clock_time_t t, void (*f)(void *), void *ptr);
+void ctimer_reset(struct ctimer *c);
+void ctimer_stop(struct ctimer *c);
+int ctimer_expired(struct ctimer *c);
+void native_timers_run(void);
+
+// Processes, the protothreads are reduced to plain functions that are never called
+typedef unsigned char process_event_t;
+typedef void *process_data_t;
+struct process { const char *name; };
+#define PROCESS_EVENT_TIMER 0x88
+#define PROCESS(name, strname) struct process name = { strname }
+#define AUTOSTART_PROCESSES(...) \
+  struct process *const autostart_processes[] = { __VA_ARGS__, NULL }
+#define PROCESS_THREAD(name, ev, data) \
+  __attribute__((unused)) static char process_thread_##name(process_event_t ev, process_data_t data)
+#define PROCESS_BEGIN() switch(0) { case 0:
+#define PROCESS_END() } return 0
+#define PROCESS_WAIT_EVENT_UNTIL(c) do { } while(!(c))
+#define PROCESS_YIELD() do { } while(0)
+#define PROCESS_PAUSE() do { } while(0)
+int process_post(struct process *p, process_event_t ev, process_data_t data);
+process_event_t process_alloc_event(void);
+
+#endif /* NATIVE_CONTIKI_H_ */
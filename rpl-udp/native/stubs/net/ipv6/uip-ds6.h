@@ -0,0 +1,8 @@
+#ifndef NATIVE_UIP_DS6_H_
+#define NATIVE_UIP_DS6_H_
+#include "net/ipv6/uip.h"
+typedef struct { uip_ipaddr_t ipaddr; } uip_ds6_addr_t;
+#define ADDR_PREFERRED 1
+uip_ds6_addr_t *uip_ds6_get_global(int8_t state);
+void uip_ds6_set_addr_iid(uip_ipaddr_t *ipaddr, const uip_lladdr_t *lladdr);
+#endif /* NATIVE_UIP_DS6_H_ */
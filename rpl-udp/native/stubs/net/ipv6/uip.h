@@ -0,0 +1,57 @@
+#ifndef NATIVE_UIP_H_
+#define NATIVE_UIP_H_
+
+#include "contiki.h"
+#include <stdint.h>
+#include <string.h>
+
+// Addresses
+typedef union { uint8_t u8[16]; uint16_t u16[8]; } uip_ip6addr_t;
+typedef uip_ip6addr_t uip_ipaddr_t;
+typedef struct { uint8_t addr[8]; } uip_lladdr_t;
+extern uip_lladdr_t uip_lladdr;
+extern const uip_ipaddr_t uip_all_zeroes_addr;
+
+#define UIP_HTONS(n) ((uint16_t)((((uint16_t)(n)) << 8) | (((uint16_t)(n)) >> 8)))
+#define uip_htons(n) UIP_HTONS(n)
+#define uip_ntohs(n) UIP_HTONS(n)
+#define uip_ipaddr_copy(dest, src) (*(dest) = *(src))
+#define uip_ipaddr_cmp(a, b) (memcmp(a, b, sizeof(uip_ip6addr_t)) == 0)
+#define uip_ip6addr(addr, a0, a1, a2, a3, a4, a5, a6, a7) do { \
+    (addr)->u16[0] = UIP_HTONS(a0); (addr)->u16[1] = UIP_HTONS(a1); \
+    (addr)->u16[2] = UIP_HTONS(a2); (addr)->u16[3] = UIP_HTONS(a3); \
+    (addr)->u16[4] = UIP_HTONS(a4); (addr)->u16[5] = UIP_HTONS(a5); \
+    (addr)->u16[6] = UIP_HTONS(a6); (addr)->u16[7] = UIP_HTONS(a7); } while(0)
+#define uip_create_linklocal_allnodes_mcast(a) uip_ip6addr(a, 0xff02, 0, 0, 0, 0, 0, 0, 0x0001)
+#define uip_is_addr_mcast(a) ((a)->u8[0] == 0xff)
+
+// Packet buffer
+#define UIP_BUFSIZE 1280
+#define UIP_IPH_LEN 40
+#define UIP_UDPH_LEN 8
+#define UIP_IPUDPH_LEN (UIP_IPH_LEN + UIP_UDPH_LEN)
+extern uint8_t uip_buf[UIP_BUFSIZE];
+extern uint16_t uip_len;
+struct uip_ip_hdr {
+  uint8_t vtc, tcflow;
+  uint16_t flow;
+  uint8_t len[2];
+  uint8_t proto, ttl;
+  uip_ip6addr_t srcipaddr, destipaddr;
+};
+#define UIP_IP_BUF ((struct uip_ip_hdr *)uip_buf)
+
+// Statistics
+#define UIP_STATISTICS 1
+typedef uint16_t uip_stats_t;
+struct uip_stats {
+  struct { uip_stats_t recv, sent, forwarded, drop; } ip;
+  struct { uip_stats_t recv, sent, drop; } udp;
+};
+extern struct uip_stats uip_stat;
+
+#define UIP_DS6_DEFAULT_PREFIX 0xfd00
+
+#include "net/ipv6/uipbuf.h"
+
+#endif /* NATIVE_UIP_H_ */
@@ -0,0 +1,5 @@
+#ifndef NATIVE_UIPBUF_H_
+#define NATIVE_UIPBUF_H_
+enum { UIPBUF_ATTR_LLSEC_LEVEL, UIPBUF_ATTR_MAX };
+uint16_t uipbuf_get_attr(uint8_t type);
+#endif /* NATIVE_UIPBUF_H_ */
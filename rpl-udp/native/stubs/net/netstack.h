@@ -0,0 +1,18 @@
+#ifndef NATIVE_NETSTACK_H_
+#define NATIVE_NETSTACK_H_
+#include "net/routing/routing.h"
+#include <stdint.h>
+extern const struct routing_driver native_routing;
+#define NETSTACK_ROUTING native_routing
+
+// IP packet processors, the input processors are run by native_ip_input on the packet in uip_buf
+typedef struct { uint8_t u8[8]; } linkaddr_t;
+enum netstack_ip_action { NETSTACK_IP_PROCESS = 0, NETSTACK_IP_DROP = 1 };
+struct netstack_ip_packet_processor {
+  struct netstack_ip_packet_processor *next;
+  enum netstack_ip_action (*process_input)(void);
+  enum netstack_ip_action (*process_output)(const linkaddr_t *localdest);
+};
+void netstack_ip_packet_processor_add(struct netstack_ip_packet_processor *p);
+enum netstack_ip_action native_ip_input(void);
+#endif /* NATIVE_NETSTACK_H_ */
@@ -0,0 +1,9 @@
+#ifndef NATIVE_ROUTING_H_
+#define NATIVE_ROUTING_H_
+#include "net/ipv6/uip.h"
+struct routing_driver {
+  void (*root_start)(void);
+  int (*node_is_reachable)(void);
+  int (*get_root_ipaddr)(uip_ipaddr_t *ipaddr);
+};
+#endif /* NATIVE_ROUTING_H_ */
@@ -0,0 +1,4 @@
+#ifndef NATIVE_RANDOM_H_
+#define NATIVE_RANDOM_H_
+unsigned short random_rand(void);
+#endif /* NATIVE_RANDOM_H_ */
@@ -0,0 +1,293 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Native implementation of the Contiki functions declared in the stand-in headers.
+
+#include "contiki.h"
+#include "random.h"
+#include "net/netstack.h"
+#include "net/ipv6/simple-udp.h"
+#include "net/ipv6/uip-ds6.h"
+#include "sys/energest.h"
+#include "sys/log.h"
+#include "sys/node-id.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/*--------------------------------------------------------------------------------------------------
+---------------------------------------------- State -----------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+clock_time_t native_clock;
+uint16_t node_id = 1;
+uip_lladdr_t uip_lladdr;
+uint8_t uip_buf[UIP_BUFSIZE];
+uint16_t uip_len;
+struct uip_stats uip_stat;
+unsigned long native_tx_packets;
+unsigned long native_tx_bytes;
+int native_log_enabled;
+
+// The last sent packet is copied here, so that a read past the end of a sent buffer is detected
+static uint8_t tx_sink[UIP_BUFSIZE];
+
+// The callback timers that were set, they are run by native_timers_run
+#define NATIVE_CTIMERS 16
+static struct ctimer *ctimers[NATIVE_CTIMERS];
+static int ctimer_count;
+
+// The IP packet processors
+static struct netstack_ip_packet_processor *processors;
+
+// The log calls are formatted here
+static char log_sink[512];
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- Functions ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+clock_time_t
+clock_time(void)
+{
+  return native_clock;
+}
+
+void
+etimer_set(struct etimer *et, clock_time_t interval)
+{
+  et->start = native_clock;
+  et->interval = interval;
+}
+
+void
+etimer_reset(struct etimer *et)
+{
+  et->start += et->interval;
+}
+
+void
+etimer_stop(struct etimer *et)
+{
+  et->interval = 0;
+}
+
+int
+etimer_expired(struct etimer *et)
+{
+  return 0;
+}
+
+clock_time_t
+etimer_expiration_time(struct etimer *et)
+{
+  return et->start + et->interval;
+}
+
+void
+ctimer_set(struct ctimer *c, clock_time_t t, void (*f)(void *), void *ptr)
+{
+  int i;
+  c->start = native_clock;
+  c->interval = t;
+  c->f = f;
+  c->ptr = ptr;
+  c->active = 1;
+  for(i = 0; i < ctimer_count; i++) {
+    if(ctimers[i] == c) {
+      return;
+    }
+  }
+  if(ctimer_count < NATIVE_CTIMERS) {
+    ctimers[ctimer_count++] = c;
+  }
+}
+
+void
+ctimer_reset(struct ctimer *c)
+{
+  c->start += c->interval;
+  c->active = 1;
+}
+
+void
+ctimer_stop(struct ctimer *c)
+{
+  c->active = 0;
+}
+
+int
+ctimer_expired(struct ctimer *c)
+{
+  return !c->active;
+}
+
+void
+native_timers_run(void)
+{
+  int i;
+  for(i = 0; i < ctimer_count; i++) {
+    if(ctimers[i]->active && native_clock - ctimers[i]->start >= ctimers[i]->interval) {
+      ctimers[i]->active = 0;
+      ctimers[i]->f(ctimers[i]->ptr);
+    }
+  }
+}
+
+int
+process_post(struct process *p, process_event_t ev, process_data_t data)
+{
+  return 0;
+}
+
+process_event_t
+process_alloc_event(void)
+{
+  static process_event_t next = 0x40;
+  return next++;
+}
+
+unsigned short
+random_rand(void)
+{
+  static uint32_t state = 12345;
+  state = state * 1103515245u + 12345u;
+  return (unsigned short)(state >> 16);
+}
+
+uint16_t
+uipbuf_get_attr(uint8_t type)
+{
+  return 0;
+}
+
+void
+energest_flush(void)
+{
+}
+
+uint64_t
+energest_type_time(int type)
+{
+  return 0;
+}
+
+static void
+root_start(void)
+{
+}
+
+static int
+node_is_reachable(void)
+{
+  return 1;
+}
+
+static int
+get_root_ipaddr(uip_ipaddr_t *ipaddr)
+{
+  uip_ip6addr(ipaddr, 0xfd00, 0, 0, 0, 0x0201, 1, 1, 1);
+  return 1;
+}
+
+const struct routing_driver native_routing = { root_start, node_is_reachable, get_root_ipaddr };
+
+uip_ds6_addr_t *
+uip_ds6_get_global(int8_t state)
+{
+  return NULL;
+}
+
+void
+uip_ds6_set_addr_iid(uip_ipaddr_t *ipaddr, const uip_lladdr_t *lladdr)
+{
+  memcpy(&ipaddr->u8[8], lladdr->addr, 8);
+  ipaddr->u8[8] ^= 0x02;
+}
+
+void
+netstack_ip_packet_processor_add(struct netstack_ip_packet_processor *p)
+{
+  struct netstack_ip_packet_processor *q;
+  for(q = processors; q != NULL; q = q->next) {
+    if(q == p) {
+      return;
+    }
+  }
+  p->next = processors;
+  processors = p;
+}
+
+enum netstack_ip_action
+native_ip_input(void)
+{
+  struct netstack_ip_packet_processor *p;
+  for(p = processors; p != NULL; p = p->next) {
+    if(p->process_input != NULL && p->process_input() == NETSTACK_IP_DROP) {
+      return NETSTACK_IP_DROP;
+    }
+  }
+  return NETSTACK_IP_PROCESS;
+}
+
+int
+simple_udp_register(struct simple_udp_connection *c, uint16_t local_port,
+                    uip_ipaddr_t *remote_addr, uint16_t remote_port,
+                    simple_udp_callback receive_callback)
+{
+  c->local_port = local_port;
+  c->remote_port = remote_port;
+  c->receive_callback = receive_callback;
+  return 1;
+}
+
+int
+simple_udp_sendto_port(struct simple_udp_connection *c, const void *data, uint16_t datalen,
+                       const uip_ipaddr_t *to, uint16_t to_port)
+{
+  uip_ipaddr_t dest;
+
+  if(datalen > UIP_BUFSIZE - UIP_IPUDPH_LEN) {
+    return 0;
+  }
+  // Like uIP the destination is kept in the connection, then the payload is moved to its place in
+  // the packet buffer and the IP header is written over the received one. The addresses that a
+  // receive callback got from simple-udp point into that header, they change with every send
+  uip_ipaddr_copy(&dest, to);
+  memmove(&uip_buf[UIP_IPUDPH_LEN], data, datalen);
+  memcpy(tx_sink, &uip_buf[UIP_IPUDPH_LEN], datalen);
+  uip_ip6addr(&UIP_IP_BUF->srcipaddr, UIP_DS6_DEFAULT_PREFIX, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(&UIP_IP_BUF->srcipaddr, &uip_lladdr);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &dest);
+  native_tx_packets++;
+  native_tx_bytes += datalen;
+  uip_stat.udp.sent++;
+  return 0;
+}
+
+int
+simple_udp_sendto(struct simple_udp_connection *c, const void *data, uint16_t datalen,
+                  const uip_ipaddr_t *to)
+{
+  return simple_udp_sendto_port(c, data, datalen, to, c->remote_port);
+}
+
+void
+native_log(const char *format, ...)
+{
+  va_list ap;
+  va_start(ap, format);
+  vsnprintf(log_sink, sizeof(log_sink), format, ap);
+  va_end(ap);
+}
+
+void
+native_log_6addr(const uip_ipaddr_t *addr)
+{
+  snprintf(log_sink, sizeof(log_sink), "%02x%02x::%02x%02x", addr->u8[0], addr->u8[1],
+           addr->u8[14], addr->u8[15]);
+}
+/*------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,9 @@
+#ifndef NATIVE_ENERGEST_H_
+#define NATIVE_ENERGEST_H_
+#include <stdint.h>
+enum { ENERGEST_TYPE_CPU, ENERGEST_TYPE_LPM, ENERGEST_TYPE_DEEP_LPM, ENERGEST_TYPE_TRANSMIT,
+       ENERGEST_TYPE_LISTEN };
+#define ENERGEST_SECOND 1000000
+void energest_flush(void);
+uint64_t energest_type_time(int type);
+#endif /* NATIVE_ENERGEST_H_ */
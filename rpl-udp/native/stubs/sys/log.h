@@ -0,0 +1,33 @@
+#ifndef NATIVE_LOG_H_
+#define NATIVE_LOG_H_
+
+// The log calls of the firmware are formatted into a buffer when native_log_enabled is set, so
+// that the fuzzer also checks the arguments of the log calls, and cost nothing otherwise
+#include "net/ipv6/uip.h"
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERR  1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DBG  4
+
+extern int native_log_enabled;
+void native_log(const char *format, ...) __attribute__((format(printf, 1, 2)));
+void native_log_6addr(const uip_ipaddr_t *addr);
+
+#define NATIVE_LOG(...) do { if(native_log_enabled) { native_log(__VA_ARGS__); } } while(0)
+#define NATIVE_LOG_6ADDR(a) do { if(native_log_enabled) { native_log_6addr(a); } } while(0)
+
+#define LOG_ERR(...) NATIVE_LOG(__VA_ARGS__)
+#define LOG_WARN(...) NATIVE_LOG(__VA_ARGS__)
+#define LOG_INFO(...) NATIVE_LOG(__VA_ARGS__)
+#define LOG_DBG(...) NATIVE_LOG(__VA_ARGS__)
+#define LOG_ERR_(...) NATIVE_LOG(__VA_ARGS__)
+#define LOG_WARN_(...) NATIVE_LOG(__VA_ARGS__)
+#define LOG_INFO_(...) NATIVE_LOG(__VA_ARGS__)
+#define LOG_DBG_(...) NATIVE_LOG(__VA_ARGS__)
+#define LOG_INFO_6ADDR(a) NATIVE_LOG_6ADDR(a)
+#define LOG_DBG_6ADDR(a) NATIVE_LOG_6ADDR(a)
+#define LOG_WARN_6ADDR(a) NATIVE_LOG_6ADDR(a)
+
+#endif /* NATIVE_LOG_H_ */
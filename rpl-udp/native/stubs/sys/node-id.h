@@ -0,0 +1,5 @@
+#ifndef NATIVE_NODE_ID_H_
+#define NATIVE_NODE_ID_H_
+#include <stdint.h>
+extern uint16_t node_id;
+#endif /* NATIVE_NODE_ID_H_ */
@@ -0,0 +1,8 @@
+#ifndef NATIVE_RTIMER_H_
+#define NATIVE_RTIMER_H_
+#include "contiki.h"
+// The rtimer follows the clock of the harness, the measured callback times are zero
+typedef uint32_t rtimer_clock_t;
+#define RTIMER_SECOND CLOCK_SECOND
+#define RTIMER_NOW() ((rtimer_clock_t)native_clock)
+#endif /* NATIVE_RTIMER_H_ */
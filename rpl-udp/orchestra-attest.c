@@ -0,0 +1,171 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Implementation of the Orchestra rule of the attestation slotframe. See orchestra-attest.h for the
+// description of the functionality.
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------- Imports of the libraries -------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+#include "orchestra-attest.h"
+#include "attest-iphc.h"
+#include "net/packetbuf.h"
+#include "net/mac/tsch/tsch.h"
+#include "sys/ctimer.h"
+#include "sys/log.h"
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Initialize ----------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Initialize the parameters for the logging module
+#define LOG_MODULE "Orchestra"
+#define LOG_LEVEL LOG_LEVEL_INFO
+
+// Initialize the handle, the channel offset and the slotframe of the rule
+static uint16_t slotframe_handle;
+static uint16_t channel_offset;
+static struct tsch_slotframe *sf_attest;
+
+// Initialize the time source of the mote (its RPL parent), the timeslots with a transmit cell and
+// the timeslots used by a packet since the last expiry of the transmit cells
+static linkaddr_t parent_addr;
+static bool tx_link[ATTEST_TSCH_PERIOD];
+static bool tx_used[ATTEST_TSCH_PERIOD];
+static struct ctimer expiry_timer;
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- Functions ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Returns the timeslot in which the mote with the given address listens
+static uint16_t
+get_node_timeslot(const linkaddr_t *addr)
+{
+  return ORCHESTRA_LINKADDR_HASH(addr) % ATTEST_TSCH_PERIOD;
+}
+
+// Returns true if the port is one of the attestation ports
+static bool
+is_attest_port(uint16_t port)
+{
+  return port == ATTEST_TSCH_CLIENT_PORT || port == ATTEST_TSCH_SERVER_PORT;
+}
+
+// Set the cell of the timeslot: a receive cell at the timeslot of the mote itself, a shared
+// transmit cell at the timeslot of a next hop, both when they are the same timeslot. The cell is
+// removed when it is neither
+static void
+update_link(uint16_t timeslot, bool tx)
+{
+  uint8_t options = (timeslot == get_node_timeslot(&linkaddr_node_addr) ? LINK_OPTION_RX : 0) |
+                    (tx ? LINK_OPTION_SHARED | LINK_OPTION_TX : 0);
+
+  if(options != 0) {
+    tsch_schedule_add_link(sf_attest, options, LINK_TYPE_NORMAL, &tsch_broadcast_address,
+                           timeslot, channel_offset, 1);
+  } else {
+    tsch_schedule_remove_link_by_timeslot(sf_attest, timeslot, channel_offset);
+  }
+  tx_link[timeslot] = tx;
+}
+
+// Returns true if the mote has a time source and it listens in the timeslot
+static bool
+is_parent_timeslot(uint16_t timeslot)
+{
+  return !linkaddr_cmp(&parent_addr, &linkaddr_null) &&
+         timeslot == get_node_timeslot(&parent_addr);
+}
+
+// Remove the transmit cells that no packet used since the last expiry, except the cell of the time
+// source. The clients always send to their parent, the servers to the next hops of the clients
+// they are challenging
+static void
+expire_links(void *ptr)
+{
+  uint16_t i;
+
+  for(i = 0; i < ATTEST_TSCH_PERIOD; i++) {
+    if(tx_link[i] && !tx_used[i] && !is_parent_timeslot(i)) {
+      update_link(i, false);
+    }
+    tx_used[i] = false;
+  }
+  ctimer_reset(&expiry_timer);
+}
+
+// Select the unicast packets of the attestation, they are sent in the cell of their next hop. The
+// transmit cell of the next hop is added when it is missing
+static int
+select_packet(uint16_t *slotframe, uint16_t *timeslot, uint16_t *channel)
+{
+  const linkaddr_t *dest = packetbuf_addr(PACKETBUF_ADDR_RECEIVER);
+  uint16_t src_port, dst_port, dest_timeslot;
+
+  if(packetbuf_attr(PACKETBUF_ATTR_FRAME_TYPE) != FRAME802154_DATAFRAME ||
+     linkaddr_cmp(dest, &linkaddr_null) ||
+     !attest_iphc_udp_ports(packetbuf_dataptr(), packetbuf_datalen(), &src_port, &dst_port) ||
+     !is_attest_port(src_port) || !is_attest_port(dst_port)) {
+    return 0;
+  }
+  dest_timeslot = get_node_timeslot(dest);
+  tx_used[dest_timeslot] = true;
+  if(!tx_link[dest_timeslot]) {
+    update_link(dest_timeslot, true);
+  }
+  if(slotframe != NULL) {
+    *slotframe = slotframe_handle;
+  }
+  if(timeslot != NULL) {
+    *timeslot = dest_timeslot;
+  }
+  if(channel != NULL) {
+    *channel = channel_offset;
+  }
+  return 1;
+}
+
+// Move the transmit cell of the time source to the new one, the cell of the old one stays until it
+// expires if packets still use it
+static void
+new_time_source(const struct tsch_neighbor *old, const struct tsch_neighbor *new)
+{
+  const linkaddr_t *new_addr = tsch_queue_get_nbr_address(new);
+
+  if(new == old) {
+    return;
+  }
+  linkaddr_copy(&parent_addr, new_addr != NULL ? new_addr : &linkaddr_null);
+  if(new_addr != NULL && !tx_link[get_node_timeslot(new_addr)]) {
+    update_link(get_node_timeslot(new_addr), true);
+  }
+}
+
+// Create the slotframe with the receive cell of the mote, the transmit cells are added per next hop
+static void
+init(uint16_t sf_handle)
+{
+  uint16_t rx_timeslot = get_node_timeslot(&linkaddr_node_addr);
+
+  slotframe_handle = sf_handle;
+  channel_offset = sf_handle;
+  sf_attest = tsch_schedule_add_slotframe(slotframe_handle, ATTEST_TSCH_PERIOD);
+  update_link(rx_timeslot, false);
+  ctimer_set(&expiry_timer, ATTEST_TSCH_TX_EXPIRY, expire_links, NULL);
+  LOG_INFO("Attestation slotframe %u of %u timeslots, receive cell %u\n",
+           slotframe_handle, ATTEST_TSCH_PERIOD, rx_timeslot);
+}
+
+struct orchestra_rule orchestra_attest = {
+  .init = init,
+  .new_time_source = new_time_source,
+  .select_packet = select_packet,
+  .name = "attestation per receiver",
+  .slotframe_size = ATTEST_TSCH_PERIOD,
+};
+/*------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,65 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Orchestra rule of the TSCH mode (make ATTEST_TSCH=1): a dedicated slotframe for the challenge
+// and response packets of the attestation, so that they do not compete with the other traffic.
+// The functionality is:
+// * The slotframe has ATTEST_TSCH_PERIOD timeslots. Every mote listens in one cell per slotframe,
+//   at the timeslot given by the hash of its link-layer address (receiver based, like the
+//   Orchestra rule unicast_per_neighbor_rpl_ns), so the cells are scheduled per mote without any
+//   negotiation and without knowing the children in the RPL non-storing mode.
+// * A mote transmits only in the cells of its next hops. The shared transmit cell of the time
+//   source (the RPL parent) is kept while it is the time source, the cell of another next hop is
+//   added by the first packet to it and removed when no packet used it for ATTEST_TSCH_TX_EXPIRY.
+//   So a client has one transmit cell and a server one per next hop of the clients it challenges,
+//   the other timeslots stay free for the other slotframes.
+// * A unicast packet between the attestation ports (the hellos, the replies, the challenges and the
+//   responses) is sent in the cell of its next hop, the packets are classified from their
+//   compressed IPHC and UDP headers (attest-iphc.h). The other packets go to the next rules.
+// * The rule comes before the unicast and the common slotframes of Orchestra in
+//   ORCHESTRA_CONF_RULES (project-conf.h), so that it selects the attestation packets before the
+//   unicast rule. Its cells have priority when they overlap, but only the few cells of the next
+//   hops transmit, so the other unicast packets keep most of the timeslots.
+//
+// The rule needs Contiki-NG 4.7 or later (named rules with their slotframe size).
+
+#ifndef ORCHESTRA_ATTEST_H_
+#define ORCHESTRA_ATTEST_H_
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------- Imports of the libraries -------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+#include "contiki.h"
+#include "orchestra.h"
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Initialize ----------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Initialize the length of the attestation slotframe, a prime number that is not the length of
+// another slotframe so that the overlaps move from one slotframe to the next
+#ifdef ATTEST_CONF_TSCH_PERIOD
+#define ATTEST_TSCH_PERIOD ATTEST_CONF_TSCH_PERIOD
+#else
+#define ATTEST_TSCH_PERIOD 11
+#endif
+
+// Initialize the time after which an unused transmit cell is removed
+#ifdef ATTEST_CONF_TSCH_TX_EXPIRY
+#define ATTEST_TSCH_TX_EXPIRY ATTEST_CONF_TSCH_TX_EXPIRY
+#else
+#define ATTEST_TSCH_TX_EXPIRY (60 * CLOCK_SECOND)
+#endif
+
+// Initialize the UDP ports of the attestation, the same as the firmware
+#define ATTEST_TSCH_CLIENT_PORT 8765
+#define ATTEST_TSCH_SERVER_PORT 5678
+
+// The rule, it is added to ORCHESTRA_CONF_RULES
+extern struct orchestra_rule orchestra_attest;
+
+#endif /* ORCHESTRA_ATTEST_H_ */
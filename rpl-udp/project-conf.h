@@ -0,0 +1,67 @@
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Description ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+//
+// version: 1.0 18Oct26
+//
+// Project configuration of the remote attestation firmware. The values can be overridden from the
+// build, e.g. make udp-server.cooja TARGET=cooja DEFINES=ATTEST_CONF_PIGGYBACK=1
+
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+/*--------------------------------------------------------------------------------------------------
+---------------------------------------- Attestation mode ------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Piggyback the attestation on the periodic traffic. The server adds the "validate" challenge to
+// the reply of the next hello of each mote, and the mote adds its "attest" response to its next
+// hello, instead of separate challenge and response packets.
+#ifndef ATTEST_CONF_PIGGYBACK
+#define ATTEST_CONF_PIGGYBACK 0
+#endif
+
+// Deadline of a challenge. In the piggyback mode the server and the mote each wait at most half of
+// it for a scheduled packet, after that they send a separate packet.
+#ifndef ATTEST_CONF_CHALLENGE_DEADLINE
+#define ATTEST_CONF_CHALLENGE_DEADLINE (150 * CLOCK_SECOND)
+#endif
+
+// Reply of the server to a hello (see attest-msg.h): 0 echoes the hello, 1 sends a short ack with
+// the sequence number of the hello and 2 sends no reply. Without a reply the clients do not wait
+// for the servers, so they do not move to another server when theirs is down.
+#ifndef ATTEST_CONF_REPLY_MODE
+#define ATTEST_CONF_REPLY_MODE 0
+#endif
+
+/*--------------------------------------------------------------------------------------------------
+-------------------------------------------- TSCH mode ---------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// TSCH mode, built with make ATTEST_TSCH=1. Orchestra schedules the enhanced beacons, the
+// attestation packets in their own slotframe (orchestra-attest.h), the other unicast packets per
+// receiver and the broadcasts in the common slotframe, in this order of priority. The attestation
+// rule comes first to select its packets, it transmits only in the cells of the next hops in use.
+#if MAC_CONF_WITH_TSCH
+struct orchestra_rule;
+extern struct orchestra_rule orchestra_attest;
+#ifndef ORCHESTRA_CONF_RULES
+#define ORCHESTRA_CONF_RULES { &eb_per_time_source, &orchestra_attest, \
+                               &unicast_per_neighbor_rpl_ns, &default_common }
+#endif
+#endif /* MAC_CONF_WITH_TSCH */
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------- Reporting ----------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Enable the counters of the packets and the radio time used by the periodic report
+#ifndef ENERGEST_CONF_ON
+#define ENERGEST_CONF_ON 1
+#endif
+
+#ifndef UIP_CONF_STATISTICS
+#define UIP_CONF_STATISTICS 1
+#endif
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,45 @@
+#!/usr/bin/env python3
+### compare-summaries.py ###########################################################################
+#
+####################################### Description ###############################################
+#
+# This script compares two simulation summaries written by the scenarios of gen-scenario.py. It
+# prints every numeric field of both summaries with the difference and the change in percent, e.g.
+# the packets and the radio on time saved per hour by the piggyback mode.
+#
+####################################### Arguments ##################################################
+#
+# Mandatory Argument: <baseline summary> <new summary>
+#
+######################################  Execution ##################################################
+#  ./tools/compare-summaries.py scenarios/piggyback-off.summary.json scenarios/piggyback-on.summary.json
+####################################################################################################
+
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        return json.loads(f.readline())
+
+
+def main():
+    if len(sys.argv) != 3:
+        print("Usage: %s <baseline summary> <new summary>" % sys.argv[0], file=sys.stderr)
+        return 1
+    base, new = load(sys.argv[1]), load(sys.argv[2])
+    print("%-28s %14s %14s %14s %9s" % ("field", base.get("name", "baseline"),
+                                         new.get("name", "new"), "difference", "change"))
+    for key in sorted(set(base) | set(new)):
+        a, b = base.get(key), new.get(key)
+        if not isinstance(a, (int, float)) or not isinstance(b, (int, float)) \
+                or isinstance(a, bool) or isinstance(b, bool):
+            continue
+        change = "%+.1f%%" % ((b - a) * 100.0 / a) if a else "-"
+        print("%-28s %14.1f %14.1f %+14.1f %9s" % (key, a, b, b - a, change))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,621 @@
+#!/usr/bin/env python3
+### gen-scenario.py ################################################################################
+#
+####################################### Description ###############################################
+#
+# This script generates Cooja simulation files (.csc) for the remote attestation firmware. A preset
+# describes one or more scenarios (number of servers, clients and malicious motes, radio medium,
+# build defines). Every generated simulation contains a ScriptRunner that stops the simulation after
+# the configured duration and writes a one line JSON summary to <scenario>.summary.json next to
+# the simulation file, and to the mote output log with the prefix "SUMMARY". The mote output is
+# written to <scenario>.motes.log (time, mote ID and message separated by tabs).
+#
+# Presets:
+#   shard-scaling   1, 2, 4 and 8 attestation servers with 10 clients per server. The summary
+#                   reports the number of attested motes, which grows linearly with the servers.
+#                   The shard-capacity scenarios run 40 clients on 1, 2 and 4 servers that hold
+#                   16 motes each (MAX_NODES), a single server cannot attest all of them.
+#   piggyback       The same network with separate challenge/response packets and with the
+#                   piggyback mode, for 3 hours. The summaries report the packets and the radio on
+#                   time per hour, compare them with tools/compare-summaries.py.
+#   scalability     50, 100, 250 and 500 motes on lossy links, dense and sparse, 5% malicious, no
+#                   speed limit. The summaries report the simulation speed (simulated seconds per
+#                   wall second), the packet delivery ratio, the attestation round time and the
+#                   detection latency of the malicious motes. Run it with tools/run-suite.sh.
+#   scalability-malicious
+#                   100 motes on the dense lossy grid with 1, 2, 5 and 10% malicious motes.
+#   tsch            20 and 50 motes on lossy links with CSMA and with TSCH and the attestation
+#                   slotframe (make ATTEST_TSCH=1), for 3 hours. The summaries report the
+#                   attestation latency (completion_ms_p50/p95/p99, from the request to validate
+#                   to the response) and the radio duty cycle.
+#   reply-modes     The piggyback network with the echo, ack and no reply modes of the server
+#                   (ATTEST_CONF_REPLY_MODE), compare the packets and the radio time per hour with
+#                   tools/compare-summaries.py.
+#
+####################################### Arguments ##################################################
+#
+# Mandatory Argument: <preset>
+# Optional Argument: --out <directory> (default: ./scenarios next to the firmware)
+# Optional Argument: --seed <random seed> (default: 123456)
+# Optional Argument: --list (print the presets and exit)
+#
+######################################  Execution ##################################################
+#  ./tools/gen-scenario.py shard-scaling
+####################################################################################################
+
+import argparse
+import json
+import math
+import os
+import random
+import sys
+from xml.sax.saxutils import escape
+
+# Directory of the firmware sources
+FIRMWARE_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# Interfaces of every Contiki mote type, the same as in the hand written simulations
+MOTE_INTERFACES = [
+    "org.contikios.cooja.interfaces.Position",
+    "org.contikios.cooja.interfaces.Battery",
+    "org.contikios.cooja.contikimote.interfaces.ContikiVib",
+    "org.contikios.cooja.contikimote.interfaces.ContikiMoteID",
+    "org.contikios.cooja.contikimote.interfaces.ContikiRS232",
+    "org.contikios.cooja.contikimote.interfaces.ContikiBeeper",
+    "org.contikios.cooja.interfaces.RimeAddress",
+    "org.contikios.cooja.interfaces.IPAddress",
+    "org.contikios.cooja.contikimote.interfaces.ContikiRadio",
+    "org.contikios.cooja.contikimote.interfaces.ContikiButton",
+    "org.contikios.cooja.contikimote.interfaces.ContikiPIR",
+    "org.contikios.cooja.contikimote.interfaces.ContikiClock",
+    "org.contikios.cooja.contikimote.interfaces.ContikiLED",
+    "org.contikios.cooja.contikimote.interfaces.ContikiCFS",
+    "org.contikios.cooja.contikimote.interfaces.ContikiEEPROM",
+    "org.contikios.cooja.interfaces.Mote2MoteRelations",
+    "org.contikios.cooja.interfaces.MoteAttributes",
+]
+
+# Default parameters of a scenario, the presets override some of them
+DEFAULTS = {
+    "servers": 1,
+    "clients": 4,
+    "malicious": 0,
+    "seed": 123456,
+    "speedlimit": None,
+    "duration_s": 1800,
+    "spacing": 35.0,
+    "topology": "sparse",
+    "tx_range": 50.0,
+    "interference_range": 100.0,
+    "success_tx": 1.0,
+    "success_rx": 1.0,
+    "defines": {},
+    "mac": "csma",
+}
+
+####################################################################################################
+# ScriptRunner script. It follows the mote output, counts the protocol events and writes the
+# summary when the simulation time is over. The @...@ placeholders are filled in per scenario.
+####################################################################################################
+
+SCRIPT = r"""
+var scenario = @SCENARIO@;
+var servers = @SERVERS@;
+var honestMax = @HONEST_MAX@;
+var verified = {};
+var perServer = {};
+var enrolled = 0;
+var rejected = 0;
+var helloSent = 0;
+var honestSent = 0;
+var redirected = 0;
+var hourly = { reports: 0, udp_tx: 0, udp_rx: 0, fwd: 0, radio_tx_ms: 0, radio_listen_ms: 0,
+               dropped: 0 };
+var quarantined = 0;
+var completions = [];
+var helloReceived = 0;
+var echoReceived = 0;
+var rounds = {};
+var roundTimes = [];
+var roundsStarted = 0;
+var keyChanged = {};
+var detections = [];
+var moteLog = [];
+
+// Wall clock at the start, for the simulation speed. The simulation runs without speed limit.
+var System = Java.type("java.lang.System");
+var wallStart = System.currentTimeMillis();
+
+TIMEOUT(@DURATION_MS@, report());
+
+// Returns the percentile p (0..1) of a sorted array
+function percentile(values, p) {
+  return values[Math.min(values.length - 1, Math.floor(values.length * p))];
+}
+
+// Returns the mote ID of a Cooja address, it is the last group of the address
+function moteId(ip) {
+  return parseInt(ip.substring(ip.lastIndexOf(":") + 1), 16);
+}
+
+// Close the current round of a server, the round is complete when every mote of the round either
+// completed the attestation or was rejected
+function closeRound(server) {
+  var r = rounds[server];
+  if (r != null && r.expected > 0 && r.resolved >= r.expected) {
+    roundTimes.push(r.last - r.start);
+  }
+  rounds[server] = null;
+}
+
+// Count a mote of the current round of a server, once per round
+function resolveRound(server, ip) {
+  var r = rounds[server];
+  if (r != null && !r.motes[ip]) {
+    r.motes[ip] = true;
+    r.resolved++;
+    r.last = sim.getSimulationTimeMillis();
+    if (r.resolved >= r.expected) {
+      closeRound(server);
+    }
+  }
+}
+
+// The mote output is kept for the result pipeline, it is written in blocks
+function flushMoteLog() {
+  if (moteLog.length > 0) {
+    log.append(scenario.name + ".motes.log", moteLog.join(""));
+    moteLog = [];
+  }
+}
+
+function report() {
+  var now = sim.getSimulationTimeMillis();
+  var attested = 0;
+  var ip;
+  for (ip in verified) {
+    // A mote counts as attested if it was verified in the last 5 minutes of the simulation
+    if (now - verified[ip].time <= 300000) {
+      attested++;
+      perServer[verified[ip].server] = (perServer[verified[ip].server] || 0) + 1;
+    }
+  }
+  scenario.sim_time_s = now / 1000;
+  scenario.hello_sent = helloSent;
+  scenario.enrolled = enrolled;
+  scenario.rejected = rejected;
+  scenario.quarantined = quarantined;
+  scenario.attested_motes = attested;
+  scenario.attested_per_server = perServer;
+
+  // Simulation speed and packet delivery ratio of the hellos, one way and with the echo reply.
+  // Only the hellos of the honest motes count, the hellos of the quarantined motes are dropped on
+  // purpose, and the hellos redirected to another server are not delivered to the application
+  scenario.wall_time_s = (System.currentTimeMillis() - wallStart) / 1000;
+  scenario.sim_speed = scenario.wall_time_s > 0 ? scenario.sim_time_s / scenario.wall_time_s : 0;
+  scenario.hello_sent_honest = honestSent;
+  scenario.hello_redirected = redirected;
+  scenario.hello_received = helloReceived;
+  scenario.echo_received = echoReceived;
+  if (honestSent - redirected > 0) {
+    scenario.pdr = helloReceived / (honestSent - redirected);
+    scenario.pdr_round_trip = echoReceived / (honestSent - redirected);
+  }
+
+  // Attestation rounds, from the start of a round to the last mote answered or rejected
+  roundTimes.sort(function(a, b) { return a - b; });
+  scenario.rounds_started = roundsStarted;
+  scenario.rounds_completed = roundTimes.length;
+  if (roundTimes.length > 0) {
+    scenario.round_ms_p50 = percentile(roundTimes, 0.5);
+    scenario.round_ms_p95 = percentile(roundTimes, 0.95);
+    scenario.round_ms_max = roundTimes[roundTimes.length - 1];
+  }
+
+  // Detection latency, from the key change of a malicious mote to its rejection by a server
+  detections.sort(function(a, b) { return a - b; });
+  scenario.detected = detections.length;
+  scenario.undetected = Object.keys(keyChanged).length;
+  if (detections.length > 0) {
+    scenario.detection_ms_p50 = percentile(detections, 0.5);
+    scenario.detection_ms_p95 = percentile(detections, 0.95);
+    scenario.detection_ms_p99 = percentile(detections, 0.99);
+    scenario.detection_ms_max = detections[detections.length - 1];
+  }
+
+  // The hourly reports of all the motes, the packets are the UDP packets sent and forwarded
+  var hours = Math.floor(now / 3600000);
+  if (hours > 0) {
+    scenario.packets_per_hour = (hourly.udp_tx + hourly.fwd) / hours;
+    scenario.radio_on_ms_per_hour = (hourly.radio_tx_ms + hourly.radio_listen_ms) / hours;
+    scenario.radio_tx_ms_per_hour = hourly.radio_tx_ms / hours;
+    scenario.quarantine_dropped_per_hour = hourly.dropped / hours;
+  }
+  // Radio duty cycle, the share of the time the radio of a mote is on (one report per mote hour)
+  if (hourly.reports > 0) {
+    scenario.duty_cycle = (hourly.radio_tx_ms + hourly.radio_listen_ms) /
+                          (hourly.reports * 3600000);
+  }
+  completions.sort(function(a, b) { return a - b; });
+  scenario.attestations_completed = completions.length;
+  if (completions.length > 0) {
+    scenario.completion_ms_p50 = percentile(completions, 0.5);
+    scenario.completion_ms_p95 = percentile(completions, 0.95);
+    scenario.completion_ms_p99 = percentile(completions, 0.99);
+  }
+  flushMoteLog();
+  var line = JSON.stringify(scenario);
+  log.log("SUMMARY " + line + "\n");
+  log.writeFile(scenario.name + ".summary.json", line + "\n");
+  log.testOK();
+}
+
+while (true) {
+  YIELD();
+  var m;
+  moteLog.push(time + "\tID:" + id + "\t" + msg + "\n");
+  if (moteLog.length >= 1000) {
+    flushMoteLog();
+  }
+  if ((m = msg.match(/Hourly report: udp tx (\d+) rx (\d+) fwd (\d+), radio tx (\d+) ms listen (\d+) ms(?:, quarantine \d+ motes dropped (\d+))?/)) != null) {
+    hourly.reports++;
+    hourly.udp_tx += parseInt(m[1]);
+    hourly.udp_rx += parseInt(m[2]);
+    hourly.fwd += parseInt(m[3]);
+    hourly.radio_tx_ms += parseInt(m[4]);
+    hourly.radio_listen_ms += parseInt(m[5]);
+    hourly.dropped += m[6] != null ? parseInt(m[6]) : 0;
+  } else if (id <= servers) {
+    if ((m = msg.match(/IP: '([^']+)' completed the attestation in (\d+) ms/)) != null) {
+      completions.push(parseInt(m[2]));
+      resolveRound(id, m[1]);
+    } else if ((m = msg.match(/Starting an attestation round for (\d+) motes/)) != null) {
+      closeRound(id);
+      rounds[id] = { start: sim.getSimulationTimeMillis(), last: sim.getSimulationTimeMillis(),
+                     expected: parseInt(m[1]), resolved: 0, motes: {} };
+      roundsStarted++;
+    } else if ((m = msg.match(/Received request '\S+ hello.*IP: '([^']+)'/)) != null) {
+      if (moteId(m[1]) <= honestMax) {
+        helloReceived++;
+      }
+    } else if ((m = msg.match(/IP: '([^']+)' is owned by the server \d+, redirecting/)) != null) {
+      if (moteId(m[1]) <= honestMax) {
+        redirected++;
+      }
+    } else if ((m = msg.match(/IP: '([^']+)' is verified/)) != null) {
+      verified[m[1]] = { time: sim.getSimulationTimeMillis(), server: id };
+    } else if (msg.indexOf("' is quarantined") >= 0) {
+      quarantined++;
+    } else if (msg.indexOf("was added to the list of known mote") >= 0) {
+      enrolled++;
+    } else if ((m = msg.match(/IP: '([^']+)' is not verified/)) != null) {
+      rejected++;
+      resolveRound(id, m[1]);
+      var mote = moteId(m[1]);
+      if (keyChanged[mote] != null) {
+        detections.push(sim.getSimulationTimeMillis() - keyChanged[mote]);
+        delete keyChanged[mote];
+      }
+    }
+  } else if (msg.indexOf("Sending request") >= 0) {
+    helloSent++;
+    if (id <= honestMax) {
+      honestSent++;
+    }
+  } else if (msg.indexOf("Received message 'hello'") >= 0 ||
+             msg.indexOf("Received message 'ack'") >= 0) {
+    if (id <= honestMax) {
+      echoReceived++;
+    }
+  } else if (msg.indexOf("The PUF key of the Malicious client is") >= 0) {
+    // The first key change counts, the following ones are detected by the same rejection
+    if (keyChanged[id] == null) {
+      keyChanged[id] = sim.getSimulationTimeMillis();
+    }
+  }
+}
+"""
+
+####################################################################################################
+# Presets
+####################################################################################################
+
+
+def preset_shard_scaling():
+    # Every server owns about 10 clients. MAX_NODES is raised a little so that the uneven share
+    # of the hashing does not drop clients, while the load of a single server stays the same.
+    scenarios = []
+    for servers in (1, 2, 4, 8):
+        clients = 10 * servers
+        scenarios.append({
+            "name": "shard-scaling-%d" % servers,
+            "servers": servers,
+            "clients": clients,
+            "defines": {
+                "ATTEST_CONF_SERVER_COUNT": servers,
+                "MAX_NODES": 16,
+                "NETSTACK_CONF_MAX_ROUTE_ENTRIES": servers + clients + 4,
+            },
+        })
+    # The same 40 clients with a fixed capacity of 16 motes per server: one server attests at most
+    # 16 of them, with more servers every server holds its own share and up to 16 * servers motes
+    # are attested
+    for servers in (1, 2, 4):
+        scenarios.append({
+            "name": "shard-capacity-%d" % servers,
+            "servers": servers,
+            "clients": 40,
+            "defines": {
+                "ATTEST_CONF_SERVER_COUNT": servers,
+                "MAX_NODES": 16,
+                "NETSTACK_CONF_MAX_ROUTE_ENTRIES": servers + 40 + 4,
+            },
+        })
+    return scenarios
+
+
+def preset_piggyback():
+    # The same network and seed in both modes, only the attestation mode is different. The
+    # simulation runs a little over 3 hours so that every mote prints 3 hourly reports.
+    scenarios = []
+    for mode in (0, 1):
+        scenarios.append({
+            "name": "piggyback-%s" % ("on" if mode else "off"),
+            "clients": 8,
+            "malicious": 1,
+            "duration_s": 3 * 3600 + 60,
+            "defines": {"ATTEST_CONF_PIGGYBACK": mode},
+        })
+    return scenarios
+
+
+def preset_reply_modes():
+    # The same network as the piggyback preset in the piggyback mode, only the reply of the server
+    # to the hellos is different
+    scenarios = []
+    for mode, name in ((0, "echo"), (1, "ack"), (2, "none")):
+        scenarios.append({
+            "name": "reply-%s" % name,
+            "clients": 8,
+            "malicious": 1,
+            "duration_s": 3 * 3600 + 60,
+            "defines": {"ATTEST_CONF_PIGGYBACK": 1, "ATTEST_CONF_REPLY_MODE": mode},
+        })
+    return scenarios
+
+
+# Topologies of the scalability suite: the spacing of the grid for a 50 m range, the dense grid
+# gives every mote about 30 neighbours and the sparse grid 4 to 8, with more hops to the root
+TOPOLOGIES = {
+    "dense": {"spacing": 15.0, "neighbors": 40},
+    "sparse": {"spacing": 35.0, "neighbors": 12},
+}
+
+
+def scalability_scenario(name, motes, topology, malicious_fraction, success):
+    # One server, the motes are the server, the clients and the malicious motes. The tables of the
+    # firmware are sized for the network: the registry of the server holds every mote and the root
+    # has a source route to every mote. The suite runs without speed limit to measure its speed.
+    malicious = max(1, int(round(motes * malicious_fraction)))
+    return {
+        "name": name,
+        "clients": motes - 1 - malicious,
+        "malicious": malicious,
+        "spacing": TOPOLOGIES[topology]["spacing"],
+        "topology": topology,
+        "success_tx": success,
+        "success_rx": success,
+        "speedlimit": None,
+        "duration_s": 1800,
+        "defines": {
+            "MAX_NODES": motes,
+            "NETSTACK_CONF_MAX_ROUTE_ENTRIES": motes + 4,
+            "NBR_TABLE_CONF_MAX_NEIGHBORS": TOPOLOGIES[topology]["neighbors"],
+        },
+    }
+
+
+def preset_scalability():
+    # 50 to 500 motes on lossy links (90% of the transmissions and receptions succeed), dense and
+    # sparse, with 5% malicious motes
+    scenarios = []
+    for motes in (50, 100, 250, 500):
+        for topology in ("dense", "sparse"):
+            scenarios.append(scalability_scenario("scalability-%d-%s" % (motes, topology),
+                                                  motes, topology, 0.05, 0.9))
+    return scenarios
+
+
+def preset_scalability_malicious():
+    # 100 motes on the dense lossy grid with 1% to 10% malicious motes, for the detection latency
+    scenarios = []
+    for percent in (1, 2, 5, 10):
+        scenarios.append(scalability_scenario("scalability-malicious-%d" % percent,
+                                              100, "dense", percent / 100.0, 0.9))
+    return scenarios
+
+
+def preset_tsch():
+    # The same networks and seeds with both MAC layers. The attestation latency is measured from the
+    # separate request to validate to the response, the piggyback mode would add the hello period.
+    scenarios = []
+    for motes in (20, 50):
+        for mac in ("csma", "tsch"):
+            scenarios.append({
+                "name": "tsch-%d-%s" % (motes, mac),
+                "clients": motes - 2,
+                "malicious": 1,
+                "spacing": TOPOLOGIES["sparse"]["spacing"],
+                "success_tx": 0.9,
+                "success_rx": 0.9,
+                "duration_s": 3 * 3600 + 60,
+                "mac": mac,
+                "defines": {
+                    "MAX_NODES": motes,
+                    "NETSTACK_CONF_MAX_ROUTE_ENTRIES": motes + 4,
+                    "NBR_TABLE_CONF_MAX_NEIGHBORS": TOPOLOGIES["sparse"]["neighbors"],
+                },
+            })
+    return scenarios
+
+
+PRESETS = {
+    "shard-scaling": preset_shard_scaling,
+    "piggyback": preset_piggyback,
+    "scalability": preset_scalability,
+    "scalability-malicious": preset_scalability_malicious,
+    "reply-modes": preset_reply_modes,
+    "tsch": preset_tsch,
+}
+
+####################################################################################################
+# Generation of the simulation file
+####################################################################################################
+
+
+def positions(count, spacing, rng):
+    # Place the motes on a square grid with a small jitter so that the links are not all equal
+    cols = max(1, int(math.ceil(math.sqrt(count))))
+    result = []
+    for i in range(count):
+        x = (i % cols) * spacing + rng.uniform(-0.1, 0.1) * spacing
+        y = (i // cols) * spacing + rng.uniform(-0.1, 0.1) * spacing
+        result.append((x, y))
+    return result
+
+
+def server_slots(servers, count):
+    # Spread the servers evenly over the grid instead of putting them next to each other
+    return [int((i + 0.5) * count / servers) for i in range(servers)]
+
+
+def make_command(firmware, defines, mac, clean):
+    command = "make -j$(CPUS) %s.cooja TARGET=cooja" % firmware
+    if mac == "tsch":
+        command += " ATTEST_TSCH=1"
+    if defines:
+        command += " DEFINES=" + ",".join("%s=%s" % (k, v) for k, v in sorted(defines.items()))
+    if clean:
+        # make does not rebuild the objects when the defines change, build from scratch once per
+        # simulation (the first mote type) so that every mote type uses the same defines
+        command = "make TARGET=cooja clean\n" + command
+    return command
+
+
+def motetype_xml(description, firmware, defines, mac, motes, clean):
+    lines = ["    <motetype>",
+             "      org.contikios.cooja.contikimote.ContikiMoteType",
+             "      <description>%s</description>" % escape(description),
+             "      <source>[CONFIG_DIR]/%s/%s.c</source>" % (
+                 os.path.relpath(FIRMWARE_DIR, OUT_DIR), firmware),
+             "      <commands>%s</commands>" % escape(make_command(firmware, defines, mac, clean))]
+    lines += ["      <moteinterface>%s</moteinterface>" % i for i in MOTE_INTERFACES]
+    for mote_id, (x, y) in motes:
+        lines += ["      <mote>",
+                  "        <interface_config>",
+                  "          org.contikios.cooja.interfaces.Position",
+                  "          <pos x=\"%.3f\" y=\"%.3f\" />" % (x, y),
+                  "        </interface_config>",
+                  "        <interface_config>",
+                  "          org.contikios.cooja.contikimote.interfaces.ContikiMoteID",
+                  "          <id>%d</id>" % mote_id,
+                  "        </interface_config>",
+                  "      </mote>"]
+    lines.append("    </motetype>")
+    return "\n".join(lines)
+
+
+def simulation_xml(sc):
+    rng = random.Random(sc["seed"])
+    total = sc["servers"] + sc["clients"] + sc["malicious"]
+    grid = positions(total, sc["spacing"], rng)
+
+    # The servers get the IDs 1..servers, they are placed on the spread slots of the grid
+    slots = server_slots(sc["servers"], total)
+    others = [p for i, p in enumerate(grid) if i not in slots]
+    server_motes = [(i + 1, grid[s]) for i, s in enumerate(slots)]
+    next_id = sc["servers"] + 1
+    client_motes = [(next_id + i, others[i]) for i in range(sc["clients"])]
+    next_id += sc["clients"]
+    malicious_motes = [(next_id + i, others[sc["clients"] + i]) for i in range(sc["malicious"])]
+
+    params = {k: sc[k] for k in ("name", "servers", "clients", "malicious", "seed",
+                                 "tx_range", "success_tx", "success_rx", "spacing", "topology",
+                                 "defines", "mac")}
+    script = (SCRIPT.replace("@SCENARIO@", json.dumps(params))
+                    .replace("@SERVERS@", str(sc["servers"]))
+                    .replace("@HONEST_MAX@", str(sc["servers"] + sc["clients"]))
+                    .replace("@DURATION_MS@", str(sc["duration_s"] * 1000)))
+
+    out = ['<?xml version="1.0" encoding="UTF-8"?>',
+           '<simconf version="2022112801">',
+           "  <simulation>",
+           "    <title>%s</title>" % escape(sc["name"])]
+    if sc["speedlimit"] is not None:
+        out.append("    <speedlimit>%s</speedlimit>" % sc["speedlimit"])
+    out += ["    <randomseed>%d</randomseed>" % sc["seed"],
+            "    <motedelay_us>1000000</motedelay_us>",
+            "    <radiomedium>",
+            "      org.contikios.cooja.radiomediums.UDGM",
+            "      <transmitting_range>%s</transmitting_range>" % sc["tx_range"],
+            "      <interference_range>%s</interference_range>" % sc["interference_range"],
+            "      <success_ratio_tx>%s</success_ratio_tx>" % sc["success_tx"],
+            "      <success_ratio_rx>%s</success_ratio_rx>" % sc["success_rx"],
+            "    </radiomedium>",
+            "    <events>",
+            "      <logoutput>40000</logoutput>",
+            "    </events>"]
+    out.append(motetype_xml("server", "udp-server", sc["defines"], sc["mac"], server_motes,
+                            True))
+    if client_motes:
+        out.append(motetype_xml("client", "udp-client", sc["defines"], sc["mac"],
+                                client_motes, False))
+    if malicious_motes:
+        out.append(motetype_xml("malicious", "udp-malicious-client", sc["defines"], sc["mac"],
+                                malicious_motes, False))
+    out += ["  </simulation>",
+            "  <plugin>",
+            "    org.contikios.cooja.plugins.ScriptRunner",
+            "    <plugin_config>",
+            "      <script>%s</script>" % escape(script),
+            "      <active>true</active>",
+            "    </plugin_config>",
+            "  </plugin>",
+            "</simconf>",
+            ""]
+    return "\n".join(out)
+
+
+def main():
+    global OUT_DIR
+    parser = argparse.ArgumentParser(description="Generate Cooja simulations from a preset")
+    parser.add_argument("preset", nargs="?", help="name of the preset")
+    parser.add_argument("--out", default=os.path.join(FIRMWARE_DIR, "scenarios"))
+    parser.add_argument("--seed", type=int, default=DEFAULTS["seed"])
+    parser.add_argument("--list", action="store_true", help="print the presets and exit")
+    args = parser.parse_args()
+
+    if args.list or args.preset is None:
+        print("\n".join(sorted(PRESETS)))
+        return 0
+    if args.preset not in PRESETS:
+        print("Unknown preset '%s', use --list to see the presets" % args.preset, file=sys.stderr)
+        return 1
+
+    OUT_DIR = os.path.abspath(args.out)
+    os.makedirs(OUT_DIR, exist_ok=True)
+    for preset in PRESETS[args.preset]():
+        sc = dict(DEFAULTS)
+        sc["seed"] = args.seed
+        sc.update(preset)
+        path = os.path.join(OUT_DIR, sc["name"] + ".csc")
+        with open(path, "w") as f:
+            f.write(simulation_xml(sc))
+        print(path)
+    return 0
+
+
+OUT_DIR = None
+
+if __name__ == "__main__":
+    sys.exit(main())
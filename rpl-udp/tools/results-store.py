@@ -0,0 +1,616 @@
+#!/usr/bin/env python3
+### results-store.py ###############################################################################
+#
+####################################### Description ###############################################
+#
+# This script merges the results of many simulation runs into a columnar results store, so that
+# the runs can be compared without reading their logs again. The commands are:
+#   ingest  Find the runs in the given directories and add them to the store. A run is a .csc file
+#           with the files of the same scenario next to it: <scenario>.summary.json (written by
+#           the scenarios of gen-scenario.py), run.json (run-suite.sh) and the mote output,
+#           <scenario>.motes.log or a LogListener output saved as <scenario>.log or loglistener.txt.
+#           A .csc file next to a directory of the same scenario is the copy of an older
+#           run-suite.sh, the run is the one in the directory. The runs are parsed in parallel, one
+#           process per core. A run that is already in the store and whose files did not change is
+#           skipped, a run whose files changed is replaced. A run whose files cannot be parsed is
+#           reported and skipped, it is tried again by the next ingest.
+#   query   Group the runs by one or more columns and aggregate a value per group, e.g. the p99 of
+#           the detection latency against the fraction of malicious motes. Only the columns of the
+#           query are read, but there is no index: the query scans every row of these columns.
+#   info    Print the columns of the store and the number of runs.
+#
+# Every run is tagged with the parameters of its simulation file: the random seed, the number of
+# motes of every firmware, the radio medium, the topology, the MAC layer, the build defines
+# (define_<NAME>, e.g. the intervals) and the duration. The metrics are the fields of the summary or, for the runs
+# without a summary, the metrics computed from the mote output. The latencies of every detection
+# and every attestation are kept as events, so that their percentiles are computed over all the
+# events of a group and not averaged over the runs.
+#
+# Layout of the store: manifest.json with the columns and, per .csc file, the run id and the
+# signature of its files, and one file per column in gen-<n>/runs/ and gen-<n>/events/, written
+# with the array module (8 byte floats, NaN for a missing value). The strings are dictionary
+# encoded: the column holds the position of the string in <column>.dict.json. Every ingest reads
+# all the columns and writes all of them again into a new generation <n>, then replaces the
+# manifest atomically, so a reader sees either the old or the new store. The previous generation is
+# kept for the readers that started before, the older ones are removed.
+#
+####################################### Arguments ##################################################
+#
+# Mandatory Argument: ingest <store> <run directory> [<run directory> ...]
+#                     query <store> --by <column[,column]> --value <column or event> [--agg <agg>]
+#                     info <store>
+# Optional Argument: --jobs <processes> (ingest, default: number of cores)
+# Optional Argument: --agg mean|median|min|max|count|sum|p50|p95|p99 (query, default: mean)
+# Optional Argument: --where <column><op><value> (query, op is = != < <= > >=, repeatable)
+# Optional Argument: --csv (query, print CSV instead of a table)
+#
+######################################  Execution ##################################################
+#  ./tools/results-store.py ingest results runs/
+#  ./tools/results-store.py query results --by malicious_fraction --value detection_ms --agg p99
+#  ./tools/results-store.py query results --by motes,mac --value duty_cycle --where topology=dense
+####################################################################################################
+
+import argparse
+import array
+import concurrent.futures
+import glob
+import json
+import math
+import os
+import re
+import shutil
+import sys
+import time
+import xml.etree.ElementTree as ET
+
+FORMAT = 2
+EVENT_KINDS = ("detection_ms", "completion_ms")
+AGGREGATES = ("mean", "median", "min", "max", "count", "sum", "p50", "p95", "p99")
+
+# Messages of the firmware, the same as the ScriptRunner of gen-scenario.py
+RE_LINE = re.compile(r"^([\d:.]+)\s+ID:(\d+)\s+(.*)$")
+RE_KEY_CHANGED = re.compile(r"The PUF key of the Malicious client is")
+RE_REJECTED = re.compile(r"IP: '([^']+)' is not verified")
+RE_COMPLETED = re.compile(r"IP: '([^']+)' completed the attestation in (\d+) ms")
+RE_HELLO_SENT = re.compile(r"Sending request")
+RE_HELLO_RECEIVED = re.compile(r"Received request '\S+ hello.*IP: '([^']+)'")
+RE_REDIRECTED = re.compile(r"IP: '([^']+)' is owned by the server \d+, redirecting")
+RE_HOURLY = re.compile(r"Hourly report: udp tx (\d+) rx (\d+) fwd (\d+), radio tx (\d+) ms "
+                       r"listen (\d+) ms")
+RE_DEFINES = re.compile(r"DEFINES=(\S+)")
+RE_SCENARIO = re.compile(r"var scenario = (\{.*?\});")
+RE_TIMEOUT = re.compile(r"TIMEOUT\((\d+)")
+
+# Firmware of a mote type and the name of its mote count
+FIRMWARES = {"udp-server": "servers", "udp-client": "clients",
+             "udp-malicious-client": "malicious"}
+
+
+####################################################################################################
+# Parsing of a run, in the worker processes
+####################################################################################################
+
+
+def find_runs(paths):
+    # Every .csc file is a run, the other files of the run have the same scenario name. Before
+    # run-suite.sh moved the simulation file into the directory of its scenario it copied it, the
+    # copy left next to the directory is not a run
+    runs = []
+    for path in paths:
+        for root, dirs, files in os.walk(path):
+            dirs.sort()
+            for name in sorted(files):
+                if not name.endswith(".csc"):
+                    continue
+                if os.path.isfile(os.path.join(root, name[:-len(".csc")], name)):
+                    continue
+                runs.append(os.path.abspath(os.path.join(root, name)))
+    return runs
+
+
+def run_files(csc):
+    directory, stem = os.path.dirname(csc), os.path.basename(csc)[:-len(".csc")]
+    files = {"csc": csc}
+    for kind, candidates in (("summary", [stem + ".summary.json"]),
+                             ("run", ["run.json"]),
+                             ("log", [stem + ".motes.log", stem + ".log", "loglistener.txt"])):
+        for candidate in candidates:
+            path = os.path.join(directory, candidate)
+            if os.path.isfile(path):
+                files[kind] = path
+                break
+    # run.json describes the only scenario of its directory (run-suite.sh)
+    if "run" in files and len(glob.glob(os.path.join(directory, "*.csc"))) > 1:
+        del files["run"]
+    return files
+
+
+def signature(files):
+    result = {}
+    for kind, path in sorted(files.items()):
+        st = os.stat(path)
+        result[kind] = [os.path.basename(path), st.st_size, st.st_mtime_ns]
+    return result
+
+
+def number(text):
+    try:
+        value = float(text)
+    except (TypeError, ValueError):
+        return text
+    return int(value) if value.is_integer() and "." not in str(text) else value
+
+
+def parse_csc(path):
+    params = {}
+    tree = ET.parse(path)
+    sim = tree.getroot().find("simulation")
+    if sim is None:
+        sim = tree.getroot()
+    seed = sim.findtext("randomseed")
+    if seed is not None:
+        params["seed"] = number(seed.strip())
+    medium = sim.find("radiomedium")
+    if medium is not None:
+        for tag, key in (("transmitting_range", "tx_range"),
+                         ("interference_range", "interference_range"),
+                         ("success_ratio_tx", "success_tx"), ("success_ratio_rx", "success_rx")):
+            if medium.findtext(tag) is not None:
+                params[key] = number(medium.findtext(tag).strip())
+
+    # The motes of every firmware and the build of the mote types
+    counts = dict.fromkeys(FIRMWARES.values(), 0)
+    params["mac"] = "csma"
+    for motetype in sim.findall("motetype"):
+        source = os.path.basename(motetype.findtext("source") or "")
+        firmware = os.path.splitext(source)[0]
+        if firmware in FIRMWARES:
+            counts[FIRMWARES[firmware]] += len(motetype.findall("mote"))
+        commands = motetype.findtext("commands") or ""
+        if "ATTEST_TSCH=1" in commands:
+            params["mac"] = "tsch"
+        m = RE_DEFINES.search(commands)
+        if m:
+            for define in m.group(1).split(","):
+                name, _, value = define.partition("=")
+                params["define_" + name] = number(value) if value else 1
+    params.update(counts)
+    params["motes"] = sum(counts.values())
+    if params["motes"] > 0:
+        params["malicious_fraction"] = round(counts["malicious"] / params["motes"], 4)
+
+    # The parameters of the scenario and the duration, from the ScriptRunner of gen-scenario.py
+    with open(path) as f:
+        text = f.read()
+    m = RE_SCENARIO.search(text)
+    if m:
+        try:
+            scenario = json.loads(m.group(1))
+        except ValueError:
+            scenario = {}
+        for key in ("name", "spacing", "topology"):
+            if key in scenario:
+                params[key] = scenario[key]
+    m = RE_TIMEOUT.search(text)
+    if m:
+        params["duration_s"] = int(m.group(1)) / 1000.0
+    return params
+
+
+def to_ms(text, microseconds):
+    # The time is in microseconds in the output of the ScriptRunner (time of the mote output) and
+    # in ms or [hh:]mm:ss.mmm in the output saved by the LogListener
+    if ":" in text:
+        seconds = 0.0
+        for part in text.split(":"):
+            seconds = seconds * 60 + float(part)
+        return seconds * 1000
+    return float(text) / 1000 if microseconds else float(text)
+
+
+def percentile(values, p):
+    return values[min(len(values) - 1, int(math.floor(len(values) * p)))]
+
+
+def mote_id(ip):
+    # The mote ID is the last group of the address, like moteId of the ScriptRunner
+    return int(ip.rsplit(":", 1)[-1], 16)
+
+
+def parse_log(path, servers, honest_max):
+    # The same counting as the ScriptRunner of gen-scenario.py, for the runs without a summary. The
+    # motes up to honest_max are the servers and the honest clients
+    microseconds = path.endswith(".motes.log")
+    key_changed, detections, completions = {}, [], []
+    metrics = {"hello_sent": 0, "hello_sent_honest": 0, "hello_redirected": 0,
+               "hello_received": 0, "rejected": 0}
+    hourly = [0, 0, 0]
+    last = 0.0
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = RE_LINE.match(line.rstrip("\n"))
+            if m is None:
+                continue
+            now, mote, msg = to_ms(m.group(1), microseconds), int(m.group(2)), m.group(3)
+            last = max(last, now)
+            h = RE_HOURLY.search(msg)
+            if h:
+                hourly[0] += 1
+                hourly[1] += int(h.group(1)) + int(h.group(3))
+                hourly[2] += int(h.group(4)) + int(h.group(5))
+            elif mote <= servers:
+                c = RE_COMPLETED.search(msg)
+                r = RE_REJECTED.search(msg) if c is None else None
+                if c:
+                    completions.append(float(c.group(2)))
+                elif r:
+                    metrics["rejected"] += 1
+                    target = mote_id(r.group(1))
+                    if target in key_changed:
+                        detections.append(now - key_changed.pop(target))
+                else:
+                    h = RE_HELLO_RECEIVED.search(msg)
+                    d = RE_REDIRECTED.search(msg) if h is None else None
+                    if h and mote_id(h.group(1)) <= honest_max:
+                        metrics["hello_received"] += 1
+                    elif d and mote_id(d.group(1)) <= honest_max:
+                        metrics["hello_redirected"] += 1
+            elif RE_HELLO_SENT.search(msg):
+                metrics["hello_sent"] += 1
+                if mote <= honest_max:
+                    metrics["hello_sent_honest"] += 1
+            elif RE_KEY_CHANGED.search(msg) and mote not in key_changed:
+                key_changed[mote] = now
+
+    metrics["sim_time_s"] = last / 1000
+    # Only the hellos of the honest motes that are not redirected to another server are delivered
+    delivered = metrics["hello_sent_honest"] - metrics["hello_redirected"]
+    if delivered > 0:
+        metrics["pdr"] = metrics["hello_received"] / delivered
+    metrics["detected"] = len(detections)
+    metrics["undetected"] = len(key_changed)
+    for name, values in (("detection_ms", sorted(detections)),
+                         ("completion_ms", sorted(completions))):
+        if values:
+            for p in (50, 95, 99):
+                metrics["%s_p%d" % (name, p)] = percentile(values, p / 100.0)
+    metrics["attestations_completed"] = len(completions)
+    hours = math.floor(last / 3600000)
+    if hours > 0:
+        metrics["packets_per_hour"] = hourly[1] / hours
+    if hourly[0] > 0:
+        metrics["duty_cycle"] = hourly[2] / (hourly[0] * 3600000.0)
+    return metrics, {"detection_ms": detections, "completion_ms": completions}
+
+
+def parse_run(csc):
+    # Returns the key of the run, the signature of its files, its columns and its events. A run
+    # whose files cannot be read or parsed returns None and the error instead of its signature
+    try:
+        return read_run(csc)
+    except (OSError, ValueError, ET.ParseError) as e:
+        return csc, None, "%s: %s" % (type(e).__name__, e), None
+
+
+def read_run(csc):
+    files = run_files(csc)
+    sig = signature(files)
+    row = {"run": csc}
+    row.update(parse_csc(csc))
+    events = {}
+    metrics = {}
+    if "log" in files:
+        servers = row.get("servers") or 1
+        metrics, events = parse_log(files["log"], servers, servers + row.get("clients", 0))
+    if "summary" in files:
+        with open(files["summary"]) as f:
+            metrics.update(json.loads(f.readline()))
+    if "run" in files:
+        with open(files["run"]) as f:
+            metrics.update(json.load(f))
+    for key, value in metrics.items():
+        # The nested values (the defines and the motes per server) are in the other columns
+        if key not in row and isinstance(value, (int, float, str, bool)):
+            row[key] = value
+    return csc, sig, row, events
+
+
+####################################################################################################
+# Columnar store
+####################################################################################################
+
+
+class Table:
+    # A table of the store, one file per column. A numeric column is an array of doubles, a string
+    # column an array of the indices of its strings in the dictionary, NaN is a missing value
+
+    def __init__(self, directory, meta):
+        self.directory = directory
+        self.meta = meta  # {"rows": n, "columns": {name: "num" or "str"}}
+
+    @property
+    def rows(self):
+        return self.meta["rows"]
+
+    def path(self, name):
+        return os.path.join(self.directory, name.replace("/", "_"))
+
+    def read(self, name):
+        values = array.array("d")
+        kind = self.meta["columns"].get(name)
+        if kind is None:
+            return [None] * self.rows
+        with open(self.path(name) + ".col", "rb") as f:
+            values.fromfile(f, self.rows)
+        if kind == "num":
+            return [None if math.isnan(v) else v for v in values]
+        with open(self.path(name) + ".dict.json") as f:
+            strings = json.load(f)
+        return [None if math.isnan(v) else strings[int(v)] for v in values]
+
+    def write(self, columns, rows):
+        # Write every column into the directory of a new generation, the manifest is not changed
+        os.makedirs(self.directory)
+        self.meta = {"rows": rows, "columns": {}}
+        for name, values in columns.items():
+            numeric = all(v is None or isinstance(v, (int, float)) for v in values)
+            data = array.array("d")
+            if numeric:
+                data.extend(float("nan") if v is None else float(v) for v in values)
+            else:
+                strings = sorted({str(v) for v in values if v is not None})
+                index = {s: i for i, s in enumerate(strings)}
+                data.extend(float("nan") if v is None else index[str(v)] for v in values)
+                with open(self.path(name) + ".dict.json", "w") as f:
+                    json.dump(strings, f)
+            with open(self.path(name) + ".col", "wb") as f:
+                data.tofile(f)
+            self.meta["columns"][name] = "num" if numeric else "str"
+
+
+def replace_json(path, value):
+    tmp = path + ".tmp"
+    with open(tmp, "w") as f:
+        json.dump(value, f, sort_keys=True)
+    os.replace(tmp, path)
+
+
+class Store:
+
+    def __init__(self, directory):
+        self.directory = directory
+        path = os.path.join(directory, "manifest.json")
+        if os.path.isfile(path):
+            with open(path) as f:
+                self.manifest = json.load(f)
+            if self.manifest.get("format") != FORMAT:
+                raise ValueError("unsupported store format %s" % self.manifest.get("format"))
+            # The files of the runs were kept under "index" before
+            if "index" in self.manifest:
+                self.manifest["files"] = self.manifest.pop("index")
+        else:
+            self.manifest = {"format": FORMAT, "generation": 0, "next_id": 0, "files": {},
+                             "runs": {"rows": 0, "columns": {}},
+                             "events": {"rows": 0, "columns": {}}}
+        generation = self.generation_dir(self.manifest["generation"])
+        self.runs = Table(os.path.join(generation, "runs"), self.manifest["runs"])
+        self.events = Table(os.path.join(generation, "events"), self.manifest["events"])
+
+    def generation_dir(self, generation):
+        return os.path.join(self.directory, "gen-%d" % generation)
+
+    def save(self, generation):
+        # The new generation becomes the store when the manifest is replaced, the previous one is
+        # kept for the readers that loaded the old manifest
+        self.manifest["generation"] = generation
+        self.manifest["runs"] = self.runs.meta
+        self.manifest["events"] = self.events.meta
+        replace_json(os.path.join(self.directory, "manifest.json"), self.manifest)
+        for path in glob.glob(os.path.join(self.directory, "gen-*")):
+            old = os.path.basename(path)[len("gen-"):]
+            if not old.isdigit() or int(old) < generation - 1:
+                shutil.rmtree(path, ignore_errors=True)
+
+    def unchanged(self, csc):
+        entry = self.manifest["files"].get(csc)
+        return entry is not None and entry["signature"] == signature(run_files(csc))
+
+    def merge(self, results):
+        # Drop the old rows of the runs that are ingested again, then append the new rows
+        replaced = {self.manifest["files"][csc]["id"] for csc, _, _, _ in results
+                    if csc in self.manifest["files"]}
+        runs = {name: self.runs.read(name) for name in self.runs.meta["columns"]}
+        events = {name: self.events.read(name) for name in self.events.meta["columns"]}
+        keep = [i for i, run_id in enumerate(runs.get("run_id", [])) if run_id not in replaced]
+        runs = {name: [values[i] for i in keep] for name, values in runs.items()}
+        keep = [i for i, run_id in enumerate(events.get("run_id", [])) if run_id not in replaced]
+        events = {name: [values[i] for i in keep] for name, values in events.items()}
+        run_rows = len(next(iter(runs.values()), []))
+        event_rows = len(next(iter(events.values()), []))
+
+        for csc, sig, row, run_events in results:
+            run_id = self.manifest["files"].get(csc, {}).get("id")
+            if run_id is None:
+                run_id = self.manifest["next_id"]
+                self.manifest["next_id"] += 1
+            self.manifest["files"][csc] = {"id": run_id, "signature": sig}
+            row = dict(row, run_id=run_id)
+            for name in set(runs) | set(row):
+                runs.setdefault(name, [None] * run_rows).append(row.get(name))
+            run_rows += 1
+            for kind, values in run_events.items():
+                for value in values:
+                    for name, v in (("run_id", run_id), ("kind", kind), ("value", value)):
+                        events.setdefault(name, [None] * event_rows).append(v)
+                    event_rows += 1
+        # A generation left by an interrupted ingest is written again
+        generation = self.manifest["generation"] + 1
+        directory = self.generation_dir(generation)
+        shutil.rmtree(directory, ignore_errors=True)
+        self.runs = Table(os.path.join(directory, "runs"), self.runs.meta)
+        self.events = Table(os.path.join(directory, "events"), self.events.meta)
+        self.runs.write(runs, run_rows)
+        self.events.write(events, event_rows)
+        self.save(generation)
+
+
+####################################################################################################
+# Commands
+####################################################################################################
+
+
+def ingest(args):
+    store = Store(args.store)
+    runs = find_runs(args.runs)
+    todo = [csc for csc in runs if not store.unchanged(csc)]
+    start = time.time()
+    # The runs are parsed in parallel, a few chunks of runs per process
+    jobs = args.jobs or os.cpu_count() or 1
+    with concurrent.futures.ProcessPoolExecutor(max_workers=jobs) as pool:
+        results = list(pool.map(parse_run, todo, chunksize=max(1, len(todo) // (4 * jobs))))
+    # The runs that failed are not in the store, the next ingest tries them again
+    failed = [(csc, error) for csc, sig, error, _ in results if sig is None]
+    for csc, error in failed:
+        print("Skipping %s, %s" % (csc, error), file=sys.stderr)
+    results = [result for result in results if result[1] is not None]
+    if results:
+        store.merge(results)
+    print("%d runs found, %d ingested, %d unchanged, %d failed, %d runs in the store (%.1f s)"
+          % (len(runs), len(results), len(runs) - len(todo), len(failed), store.runs.rows,
+             time.time() - start))
+    return 0
+
+
+def parse_where(text):
+    m = re.match(r"^([\w.]+)\s*(!=|<=|>=|=|<|>)\s*(.*)$", text)
+    if m is None:
+        raise ValueError("invalid condition %s" % text)
+    name, op, value = m.groups()
+    value = number(value)
+    tests = {"=": lambda v: v == value, "!=": lambda v: v != value,
+             "<": lambda v: v < value, "<=": lambda v: v <= value,
+             ">": lambda v: v > value, ">=": lambda v: v >= value}
+    test = tests[op]
+
+    def check(v):
+        if v is None:
+            return False
+        try:
+            return test(v)
+        except TypeError:
+            return False
+    return name, check
+
+
+def aggregate(values, agg):
+    values = sorted(v for v in values if v is not None)
+    if agg == "count":
+        return len(values)
+    if not values:
+        return None
+    if agg == "mean":
+        return sum(values) / len(values)
+    if agg == "sum":
+        return sum(values)
+    if agg == "min":
+        return values[0]
+    if agg == "max":
+        return values[-1]
+    if agg == "median":
+        return percentile(values, 0.5)
+    return percentile(values, int(agg[1:]) / 100.0)
+
+
+def query(args):
+    start = time.time()
+    store = Store(args.store)
+    by = args.by.split(",")
+    conditions = [parse_where(w) for w in args.where]
+    for name in by + [name for name, _ in conditions]:
+        if name not in store.runs.meta["columns"]:
+            raise ValueError("unknown column %s, see the info command" % name)
+
+    # Only the columns of the query are read
+    names = set(by) | {name for name, _ in conditions} | {"run_id"}
+    events = args.value in EVENT_KINDS
+    if not events:
+        if args.value not in store.runs.meta["columns"]:
+            raise ValueError("unknown column %s, see the info command" % args.value)
+        names.add(args.value)
+    columns = {name: store.runs.read(name) for name in names}
+    selected = [i for i in range(store.runs.rows)
+                if all(check(columns[name][i]) for name, check in conditions)]
+
+    groups = {}
+    group_of_run = {}
+    for i in selected:
+        key = tuple(columns[name][i] for name in by)
+        groups.setdefault(key, {"runs": 0, "values": []})["runs"] += 1
+        if events:
+            group_of_run[columns["run_id"][i]] = key
+        else:
+            groups[key]["values"].append(columns[args.value][i])
+    if events:
+        # The events of all the runs of a group are pooled
+        kinds, run_ids, values = (store.events.read(n) for n in ("kind", "run_id", "value"))
+        for kind, run_id, value in zip(kinds, run_ids, values):
+            if kind == args.value and run_id in group_of_run:
+                groups[group_of_run[run_id]]["values"].append(value)
+
+    def sort_key(key):
+        return tuple((0, v, "") if isinstance(v, (int, float)) else (1, 0, str(v)) for v in key)
+
+    header = by + ["runs", "%s(%s)" % (args.agg, args.value)]
+    rows = []
+    for key in sorted(groups, key=sort_key):
+        value = aggregate(groups[key]["values"], args.agg)
+        rows.append([("" if v is None else v) for v in key] +
+                    [groups[key]["runs"], "" if value is None else value])
+    if args.csv:
+        print(",".join(header))
+        for row in rows:
+            print(",".join("%g" % v if isinstance(v, float) else str(v) for v in row))
+    else:
+        print("".join("%-20s" % h for h in header))
+        for row in rows:
+            print("".join("%-20.6g" % v if isinstance(v, float) else "%-20s" % v for v in row))
+    print("%d runs in %d groups (%.3f s)" % (len(selected), len(groups), time.time() - start),
+          file=sys.stderr)
+    return 0
+
+
+def info(args):
+    store = Store(args.store)
+    print("%d runs, %d events" % (store.runs.rows, store.events.rows))
+    for name, kind in sorted(store.runs.meta["columns"].items()):
+        print("  %-40s %s" % (name, kind))
+    print("events: %s" % ", ".join(EVENT_KINDS))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Columnar store of the simulation results")
+    sub = parser.add_subparsers(dest="command", required=True)
+    p = sub.add_parser("ingest")
+    p.add_argument("store")
+    p.add_argument("runs", nargs="+")
+    p.add_argument("--jobs", type=int, default=None)
+    p = sub.add_parser("query")
+    p.add_argument("store")
+    p.add_argument("--by", required=True)
+    p.add_argument("--value", required=True)
+    p.add_argument("--agg", choices=AGGREGATES, default="mean")
+    p.add_argument("--where", action="append", default=[])
+    p.add_argument("--csv", action="store_true")
+    p = sub.add_parser("info")
+    p.add_argument("store")
+    args = parser.parse_args()
+    try:
+        return {"ingest": ingest, "query": query, "info": info}[args.command](args)
+    except ValueError as e:
+        print("Error: %s" % e, file=sys.stderr)
+        return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
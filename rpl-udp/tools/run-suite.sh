@@ -0,0 +1,88 @@
+#!/bin/bash
+### run-suite.sh ###################################################################################
+#
+####################################### Description ###############################################
+#
+# This script runs a preset of gen-scenario.py in Cooja without GUI and collects the results. Every
+# scenario gets its own directory in the run directory with the simulation file, the mote output
+# (<scenario>.motes.log), the Cooja output (cooja.log), the summary (<scenario>.summary.json) and
+# run.json with the wall time, the exit code and the git revision of the firmware. The summaries
+# of all the scenarios, with the run information, are collected in suite.jsonl, one line per
+# scenario, so that the runs of different releases can be compared (tools/compare-summaries.py).
+#
+# The scenarios run one after the other: every simulation builds the firmware in the same
+# directory, and parallel runs would change the simulation speed that is measured.
+#
+# Cooja is started with $COOJA followed by the Cooja arguments. By default it is run with gradle
+# from the Contiki-NG tree in $CONTIKI (default: ../.. from the firmware, like the Makefile).
+#
+####################################### Arguments ##################################################
+#
+# Mandatory Argument: <preset>
+# Optional Argument: <run directory> (default: runs/<preset>-<date> next to the firmware)
+#
+######################################  Execution ##################################################
+#  ./tools/run-suite.sh scalability
+#  COOJA="java -jar cooja.jar" ./tools/run-suite.sh scalability-malicious /tmp/run1
+####################################################################################################
+
+preset=$1
+if [[ -z "$preset" ]]; then
+   echo "Usage: $0 <preset> [run directory]"
+   exit 1
+fi
+
+firmwareDir=$(cd "$(dirname "$0")/.." && pwd)
+CONTIKI=${CONTIKI:-$(cd "$firmwareDir/../.." && pwd)}
+COOJA=${COOJA:-"$CONTIKI/tools/cooja/gradlew --no-watch-fs --quiet -p $CONTIKI/tools/cooja run --args="}
+runDir=${2:-"$firmwareDir/runs/${preset}-$(date +%Y%m%d-%H%M%S)"}
+gitRev=$(git -C "$firmwareDir" rev-parse --short HEAD 2>/dev/null || echo "unknown")
+
+# Generate the simulation files in the run directory
+mkdir -p "$runDir" || exit 1
+runDir=$(cd "$runDir" && pwd)
+scenarios=$("$firmwareDir/tools/gen-scenario.py" "$preset" --out "$runDir")
+if [[ $? -ne 0 || -z "$scenarios" ]]; then
+   echo "The scenarios of the preset '${preset}' could not be generated"
+   exit 1
+fi
+
+failed=0
+for csc in $scenarios; do
+   name=$(basename "$csc" .csc)
+   dir="$runDir/$name"
+   mkdir -p "$dir"
+   # The simulation file is moved, so that a run is found once (tools/results-store.py)
+   mv "$csc" "$dir/"
+   csc="$dir/$name.csc"
+   echo "Running ${name}"
+
+   # The ScriptRunner writes its files in the working directory of Cooja
+   start=$(date +%s.%N)
+   if [[ "$COOJA" == *"--args=" ]]; then
+      (cd "$dir" && $COOJA"--no-gui --contiki=$CONTIKI --logdir=$dir $csc") > "$dir/cooja.log" 2>&1
+   else
+      (cd "$dir" && $COOJA --no-gui --contiki="$CONTIKI" --logdir="$dir" "$csc") > "$dir/cooja.log" 2>&1
+   fi
+   status=$?
+   end=$(date +%s.%N)
+
+   wall=$(awk "BEGIN { printf \"%.3f\", $end - $start }")
+   printf '{"scenario": "%s", "preset": "%s", "git_rev": "%s", "exit_code": %d, "run_wall_s": %s}\n' \
+      "$name" "$preset" "$gitRev" "$status" "$wall" > "$dir/run.json"
+
+   if [[ $status -ne 0 || ! -f "$dir/$name.summary.json" ]]; then
+      echo "The scenario ${name} failed (exit code ${status}), see ${dir}/cooja.log"
+      failed=$((failed + 1))
+      continue
+   fi
+
+   # One line per scenario with the summary and the run information
+   python3 -c 'import json,sys; s=json.load(open(sys.argv[1])); s.update(json.load(open(sys.argv[2]))); print(json.dumps(s, sort_keys=True))' \
+      "$dir/$name.summary.json" "$dir/run.json" >> "$runDir/suite.jsonl"
+   python3 -c 'import json,sys; s=json.load(open(sys.argv[1])); print("  sim speed %.2f, pdr %.3f, round p50 %s ms, detection p95 %s ms" % (s.get("sim_speed", 0), s.get("pdr", 0), s.get("round_ms_p50", "-"), s.get("detection_ms_p95", "-")))' \
+      "$dir/$name.summary.json"
+done
+
+echo "Results in ${runDir}/suite.jsonl, ${failed} scenarios failed"
+[[ $failed -eq 0 ]]
@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+### stats-query.py #################################################################################
+#
+####################################### Description ###############################################
+#
+# This script queries and decodes the runtime statistics of the motes (attest-stats.h). The
+# commands are:
+#   query   Send a query to a mote on UDP port 5681 and print the decoded response. The host needs
+#           a route to the mote, e.g. through a border router (tunslip6) or the Cooja serial socket.
+#           A response fits in one radio frame, so the statistics come in several pages, the
+#           script asks for every page and joins them.
+#   decode  Decode a response given in hex as printed by the server, all its pages one after the
+#           other.
+#   log     Decode the "Stats of IP: '<ip>' <hex>" lines of a mote output log, these are the pages
+#           polled by the server (ATTEST_CONF_STATS_POLL). With --json one JSON object is printed
+#           per response.
+# The names of the counters, gauges and histograms follow the order of attest-stats.h.
+#
+####################################### Arguments ##################################################
+#
+# Mandatory Argument: query <IPv6 address>
+#                     decode <hex page> [<hex page> ...]
+#                     log <mote output log>
+# Optional Argument: --sections counters,gauges,histograms (query, default: all)
+# Optional Argument: --reset (query, clear the counters and the histograms after the response,
+#                    only with firmware built with ATTEST_CONF_STATS_RESET=1)
+# Optional Argument: --timeout <seconds> (query, default: 5)
+# Optional Argument: --json (print the responses as JSON)
+#
+######################################  Execution ##################################################
+#  ./tools/stats-query.py query fd00::202:2:2:2 --reset
+#  ./tools/stats-query.py log scenarios/scalability-100-dense.motes.log --json
+####################################################################################################
+
+import argparse
+import json
+import re
+import socket
+import struct
+import sys
+
+PORT = 5681
+VERSION = 2
+HEADER_LEN = 6
+
+COUNTERS = ["rx", "rx_dropped", "verified", "rejected", "enrolled", "registry_full", "tx",
+            "tx_bytes", "challenges", "completed", "expired", "missed", "redirects",
+            "quarantined", "quarantine_dropped", "queries", "quarantine_full"]
+GAUGES = ["registry", "challenges", "quarantine"]
+HISTOGRAMS = ["callback_ticks", "tx_bytes", "attest_ms"]
+ROLES = ["server", "client", "malicious"]
+SECTIONS = {"counters": 0x01, "gauges": 0x02, "histograms": 0x04}
+FLAG_RESET = 0x01
+
+LOG_LINE = re.compile(r"Stats of IP: '([^']*)' ([0-9a-f]+)")
+
+
+def name(names, i):
+    return names[i] if i < len(names) else "unknown_%d" % i
+
+
+def bucket_range(b, buckets):
+    # Bucket 0 counts the value 0, bucket b the values from 2^(b-1) to 2^b - 1 and the last bucket
+    # also the larger values
+    if b == 0:
+        return "0"
+    if b == buckets - 1:
+        return "%d+" % (1 << (b - 1))
+    return "%d-%d" % (1 << (b - 1), (1 << b) - 1)
+
+
+def page_of(data):
+    # Returns the sections, the page, the number of pages and the part of the body of a response
+    if len(data) < HEADER_LEN or data[0:1] != b"S" or data[2:3] != b"r":
+        raise ValueError("not a stats response")
+    if data[1] != VERSION:
+        raise ValueError("unsupported version %d" % data[1])
+    if data[4] >= data[5]:
+        raise ValueError("page %d of %d" % (data[4], data[5]))
+    return data[3], data[4], data[5], data[HEADER_LEN:]
+
+
+def join(responses):
+    # Returns the sections and the body of the pages of one response, in order
+    body = b""
+    sections = None
+    for i, data in enumerate(responses):
+        sections, page, pages, part = page_of(data)
+        if page != i:
+            raise ValueError("page %d instead of %d" % (page, i))
+        body += part
+    if sections is None or page != pages - 1:
+        raise ValueError("incomplete response")
+    return sections, body
+
+
+def decode(sections, data):
+    if len(data) < 7:
+        raise ValueError("response too short")
+    role = data[0]
+    node_id, uptime = struct.unpack_from("!HI", data, 1)
+    result = {"node_id": node_id, "role": name(ROLES, role), "uptime_s": uptime}
+    p = 7
+    if sections & SECTIONS["counters"]:
+        n = data[p]
+        values = struct.unpack_from("!%dI" % n, data, p + 1)
+        result["counters"] = {name(COUNTERS, i): v for i, v in enumerate(values)}
+        p += 1 + 4 * n
+    if sections & SECTIONS["gauges"]:
+        n = data[p]
+        values = struct.unpack_from("!%dH" % n, data, p + 1)
+        result["gauges"] = {name(GAUGES, i): v for i, v in enumerate(values)}
+        p += 1 + 2 * n
+    if sections & SECTIONS["histograms"]:
+        n, buckets = data[p], data[p + 1]
+        values = struct.unpack_from("!%dH" % (n * buckets), data, p + 2)
+        result["histograms"] = {
+            name(HISTOGRAMS, i): {bucket_range(b, buckets): values[i * buckets + b]
+                                  for b in range(buckets) if values[i * buckets + b]}
+            for i in range(n)}
+        p += 2 + 2 * n * buckets
+    if p != len(data):
+        raise ValueError("response of %d bytes, expected %d" % (len(data), p))
+    return result
+
+
+def show(result, as_json, address=None):
+    if address is not None:
+        result = dict(result, address=address)
+    if as_json:
+        print(json.dumps(result, sort_keys=True))
+        return
+    print(("%s node %d (%s), up %d s" % (result.get("address", ""), result["node_id"],
+                                         result["role"], result["uptime_s"])).strip())
+    for key, values in result.get("counters", {}).items():
+        print("  %-20s %10d" % (key, values))
+    for key, values in result.get("gauges", {}).items():
+        print("  %-20s %10d (gauge)" % (key, values))
+    for key, values in result.get("histograms", {}).items():
+        print("  %-20s %s" % (key, " ".join("%s:%d" % kv for kv in values.items()) or "-"))
+
+
+def query(args):
+    sections = 0
+    for section in args.sections.split(","):
+        if section not in SECTIONS:
+            raise ValueError("unknown section %s" % section)
+        sections |= SECTIONS[section]
+    flags = FLAG_RESET if args.reset else 0
+    target = args.target[0]
+    sock = socket.socket(socket.AF_INET6, socket.SOCK_DGRAM)
+    sock.settimeout(args.timeout)
+
+    # One query per page, the number of pages is in every response
+    responses = []
+    pages = 1
+    while len(responses) < pages:
+        page = len(responses)
+        sock.sendto(struct.pack("!cBcBBB", b"S", VERSION, b"q", sections, flags, page),
+                    (target, PORT))
+        try:
+            data, _ = sock.recvfrom(1024)
+        except socket.timeout:
+            print("No response from %s for the page %d" % (target, page), file=sys.stderr)
+            return 1
+        _, received, pages, _ = page_of(data)
+        if received == page:
+            responses.append(data)
+    show(decode(*join(responses)), args.json, target)
+    return 0
+
+
+def read_log(path, as_json):
+    # The pages of a mote are printed one after the other, a page 0 starts a new response
+    pending = {}
+    with open(path) as f:
+        for line in f:
+            m = LOG_LINE.search(line)
+            if m is None:
+                continue
+            address = m.group(1)
+            try:
+                data = bytes.fromhex(m.group(2))
+                _, page, pages, _ = page_of(data)
+                if page == 0:
+                    pending[address] = []
+                pending.setdefault(address, []).append(data)
+                if page == pages - 1:
+                    show(decode(*join(pending.pop(address))), as_json, address)
+            except ValueError as e:
+                pending.pop(address, None)
+                print("%s: %s" % (address, e), file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Query and decode the statistics of the motes")
+    parser.add_argument("command", choices=["query", "decode", "log"])
+    parser.add_argument("target", nargs="+",
+                        help="IPv6 address, hex pages of a response or mote output log")
+    parser.add_argument("--sections", default="counters,gauges,histograms")
+    parser.add_argument("--reset", action="store_true")
+    parser.add_argument("--timeout", type=float, default=5.0)
+    parser.add_argument("--json", action="store_true")
+    args = parser.parse_args()
+
+    try:
+        if args.command == "query":
+            return query(args)
+        if args.command == "decode":
+            show(decode(*join([bytes.fromhex(h) for h in args.target])), args.json)
+            return 0
+        read_log(args.target[0], args.json)
+    except ValueError as e:
+        print("Error: %s" % e, file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -19,6 +19,14 @@
 //   arrays to verify if the mote had sent a message in the past. If mote had sent a message in the
 //   past and the key is matching then the message is received. Otherwise, the mote closes the
 //   connection.
+// * When more than one attestation server is configured (ATTEST_SERVER_COUNT), the mote sends its
+//   messages to the server that owns it (see attest-shard.h). A server that does not answer is
+//   dropped and the mote moves to the next owner, and a "moved" reply updates the live servers.
+// * The mote answers a validation request with an "attest" message. In the piggyback mode
+//   (ATTEST_CONF_PIGGYBACK) the answer is added to the next hello when it is sent in time.
+// * Built with make ATTEST_TSCH=1 the mote runs TSCH instead of CSMA, the attestation packets
+//   have their own Orchestra slotframe (see orchestra-attest.h).
+// * Every hour the mote prints the number of packets and the radio time (see attest-report.h).
 // * Finally, the mote after some random time performs the same actions again.
 
 /*--------------------------------------------------------------------------------------------------
@@ -33,6 +41,13 @@
 #include <stdint.h>
 #include <inttypes.h>
 #include "sys/log.h"
+#include "attest-shard.h"
+#include "attest-report.h"
+#include "attest-msg.h"
+#include "attest-registry.h"
+#include "attest-quarantine.h"
+#include "attest-stats.h"
+#include "sys/rtimer.h"
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -66,7 +81,7 @@ const bool server = false;
 --------------------------------------------------------------------------------------------------*/
 
 // Initialize the PUF key
-char local_client_key[20] = "initialkey";
+char local_client_key[ATTEST_KEY_SIZE] = "initialkey";
 
 // Initialize the parameters for the validation
 bool initialSetupPUF=true;
@@ -76,17 +91,7 @@ bool validate = false;
 ---------------------------------- Initialize arrays for the nodes ---------------------------------
 --------------------------------------------------------------------------------------------------*/
 
-// Initialize the maximum nodes
-#define MAX_NODES 10
-
-// Initialize the remote keys array
-char remotekeys[MAX_NODES][20];
-
-// Initialize the sender port array
-uint16_t sender_ports[MAX_NODES];
-
-// Initialize the IP array
-uip_ipaddr_t sender_addrs[MAX_NODES];
+// The remote keys, sender ports and IP arrays are kept by the registry (see attest-registry.h)
 
 // Initialize the zero IPv6 address
 const uip_ipaddr_t uip_all_zeroes_addr;
@@ -101,78 +106,106 @@ static struct simple_udp_connection udp_conn;
 // Initialize the rx counter
 static uint32_t rx_count = 0;
 
+// Initialize the index of the attestation server and whether its reply is still expected
+static uint8_t server_index = ATTEST_MAX_SERVERS;
+static bool awaiting_reply = false;
+
+// Create the instance of the timer of the periodic messages
+static struct etimer periodic_timer;
+
+// Initialize whether an "attest" response waits for the next hello (piggyback mode)
+static bool attest_pending = false;
+
 // Create the UDP Client process and start it
 PROCESS(udp_client_process, name);
 AUTOSTART_PROCESSES(&udp_client_process);
 
-// Call back function. This function is used to process the received messages from the UDP client
+// Answer the validation request of the server. In the piggyback mode the answer is added to the next
+// hello if it is sent in half of the challenge deadline, otherwise a separate message is sent.
 static void
-udp_rx_callback(struct simple_udp_connection *c,
-                const uip_ipaddr_t *sender_addr,
-                uint16_t sender_port,
-                const uip_ipaddr_t *receiver_addr,
-                uint16_t receiver_port,
-                const uint8_t *data,
-                uint16_t datalen)
+respond_to_challenge(const uip_ipaddr_t *server_addr)
 {
-  // The following code block gets the key from the message
-  char data_copy[121];
-  memcpy(data_copy, data, datalen);
-  data_copy[121] = '\0';
-  char *token = strtok(data_copy, " ");
-  char remotekey[20];
-  if (token != NULL) {
-    strcpy(remotekey, token);
+  static char response[32];
+  attest_stats_inc(ATTEST_STAT_CHALLENGES);
+#if ATTEST_CONF_PIGGYBACK
+  if (etimer_expiration_time(&periodic_timer) - clock_time() < ATTEST_CONF_CHALLENGE_DEADLINE / 2) {
+    LOG_INFO("The response to the validation request is added to the next hello\n");
+    attest_pending = true;
+    return;
   }
-  // The following code block gets the message, and validates if there is a validation message send
-  char *taken = strtok(NULL, " ");
-  LOG_INFO("Received message '%s'\n",taken);
-  if (taken != NULL && strcmp(taken, "validate") == 0) {
-    LOG_INFO("Received validation message\n");
-    validate=true;
+#endif /* ATTEST_CONF_PIGGYBACK */
+  LOG_INFO("Sending the response to the validation request with key: %s\n", local_client_key);
+  snprintf(response, sizeof(response), "%s attest", local_client_key);
+  attest_stats_sendto(&udp_conn, response, strlen(response), server_addr);
+}
+
+// Call back function. This function is used to process the received messages from the UDP client
+static void
+udp_rx_process(struct simple_udp_connection *c,
+               const uip_ipaddr_t *sender_addr,
+               uint16_t sender_port,
+               const uip_ipaddr_t *receiver_addr,
+               uint16_t receiver_port,
+               const uint8_t *data,
+               uint16_t datalen)
+{
+  // The following code block gets the key and the items from the message. The parser checks the
+  // lengths and works on the received data without copying it
+  struct attest_msg msg;
+  int result = attest_msg_parse(data, datalen, &msg);
+  if (result != ATTEST_MSG_OK) {
+    attest_stats_inc(ATTEST_STAT_RX_DROPPED);
+    LOG_INFO("Dropping a message (%s) from IP: '", attest_msg_error(result));
+    LOG_INFO_6ADDR(sender_addr);
+    LOG_INFO_("'\n");
+    return;
   }
+  char remotekey[ATTEST_KEY_SIZE];
+  attest_msg_copy_key(&msg, remotekey);
 
   // The following code block performs the validation of the KEY received and the IP of the sender
   int i;
-  for (i = 0; i < MAX_NODES; i++) {
-    // Get the IP of the sender
-    uip_ipaddr_t* ip_ptr = &sender_addrs[i];
-    // Perform a validation if the sender IP and port already exist in the aforementioned arrays
-    if (sender_ports[i] == sender_port && memcmp(ip_ptr, sender_addr, sizeof(uip_ip6addr_t)) == 0){
-      // Verify if the remote key is validated or not
-      if (strcmp(remotekeys[i], remotekey) == 0){
-        // Key is validated
-        LOG_INFO("The key '%s' of the node with Port:'%u' ",remotekey,sender_port);
-        LOG_INFO_("IP: '");
-        LOG_INFO_6ADDR(sender_addr);
-        LOG_INFO_("' is verified.\n");
-        break;
-      }
-      else{
-        // Key is not validated
-        LOG_INFO("The key '%s' of the node with Port:'%u' ",remotekey,sender_port);
-        LOG_INFO_("IP: '");
-        LOG_INFO_6ADDR(sender_addr);
-        LOG_INFO_("' is not verified closing the communication with this node.\n");
-        // Drop the connection with no further processing
-        return;
-        break;
-      }
+  switch (attest_registry_check(sender_addr, sender_port, &msg, &i)) {
+  case ATTEST_REGISTRY_VERIFIED:
+    // Key is validated
+    attest_stats_inc(ATTEST_STAT_VERIFIED);
+    LOG_INFO("The key '%s' of the node with Port:'%u' ",remotekey,sender_port);
+    LOG_INFO_("IP: '");
+    LOG_INFO_6ADDR(sender_addr);
+    LOG_INFO_("' is verified.\n");
+    break;
+  case ATTEST_REGISTRY_REJECTED:
+    // Key is not validated
+    attest_stats_inc(ATTEST_STAT_REJECTED);
+    LOG_INFO("The key '%s' of the node with Port:'%u' ",remotekey,sender_port);
+    LOG_INFO_("IP: '");
+    LOG_INFO_6ADDR(sender_addr);
+    LOG_INFO_("' is not verified closing the communication with this node.\n");
+    // Drop the connection with no further processing
+    return;
+  case ATTEST_REGISTRY_ENROLLED:
+    // In this case the node has sent a message for the first time, the IP, port and the key of the
+    // node are stored in an empty cell in the arrays
+    attest_stats_inc(ATTEST_STAT_ENROLLED);
+    LOG_INFO("The mote with:key '%s' ,Port:'%u' ",remotekey,sender_port);
+    LOG_INFO_(",IP: '");
+    LOG_INFO_6ADDR(sender_addr);
+    LOG_INFO_("' was added to the list of known mote.\n");
+    break;
+  case ATTEST_REGISTRY_FULL:
+    // The arrays are full, the message is processed without keeping the mote
+    attest_stats_inc(ATTEST_STAT_REGISTRY_FULL);
+    LOG_INFO("The list of known motes is full, the mote with Port:'%u' is not stored.\n",
+             sender_port);
+    break;
   }
-  else{
-    // In this case the node has sent a message for the first time, saving in the arrays the IP, port
-    // and the key of the node. The values are stored in an empty cell in the arrays
-    if (sender_ports[i] == 0 && uip_ipaddr_cmp(&sender_addrs[i], &uip_all_zeroes_addr)) {
-      strcpy(remotekeys[i], token);
-      sender_ports[i] = sender_port;
-      uip_ipaddr_copy(&sender_addrs[i], sender_addr);
-      LOG_INFO("The mote with:key '%s' ,Port:'%u' ",remotekey,sender_port);
-      LOG_INFO_(",IP: '");
-      LOG_INFO_6ADDR(sender_addr);
-      LOG_INFO_("' was added to the list of known mote.\n");
-      break;
-     }
-    }
+
+  // The following code block gets the message, and validates if there is a validation message send.
+  // A message can carry more than one item, e.g. the echo of a hello followed by "validate"
+  LOG_INFO("Received message '%.*s'\n", msg.first_len, msg.first != NULL ? msg.first : "");
+  if (msg.items & ATTEST_ITEM_VALIDATE) {
+    LOG_INFO("Received validation message\n");
+    validate=true;
   }
 
   // Validation code block, in case the Server sends a validate message this node will keep its
@@ -180,6 +213,7 @@ udp_rx_callback(struct simple_udp_connection *c,
   //We need to keep the key the same.
   if(validate){
     LOG_INFO("The key remains for the client '%s' the same\n",local_client_key);
+    respond_to_challenge(sender_addr);
     validate=false;
   }
 
@@ -189,20 +223,52 @@ udp_rx_callback(struct simple_udp_connection *c,
   LOG_INFO_6ADDR(sender_addr);
   LOG_INFO_("'\n");
 
+  // The following code block handles the replies of the attestation servers. A reply means that
+  // the server is alive, and a "moved" message means that this mote is owned by another server.
+  uint8_t reply_server = attest_shard_server_index(sender_addr);
+  if (reply_server < ATTEST_MAX_SERVERS) {
+    attest_shard_answered(reply_server);
+    awaiting_reply = false;
+    if (msg.items & ATTEST_ITEM_MOVED) {
+      attest_stats_inc(ATTEST_STAT_REDIRECTS);
+      attest_shard_set_live_mask(msg.moved_mask);
+      LOG_INFO("Redirected by the server %u, live servers mask: 0x%04x\n",
+               reply_server + 1, attest_shard_live_mask());
+    }
+  }
+
 #if LLSEC802154_CONF_ENABLED
   LOG_INFO_(" LLSEC LV:%d", uipbuf_get_attr(UIPBUF_ATTR_LLSEC_LEVEL));
 #endif
   rx_count++;
 }
 
+// Call back function. This function counts the received messages and measures their processing in
+// rtimer ticks for the statistics. The addresses given by simple-udp point into the IP header in
+// uip_buf, which is overwritten by the response to a challenge, so they are copied first
+static void
+udp_rx_callback(struct simple_udp_connection *c,
+                const uip_ipaddr_t *sender_addr,
+                uint16_t sender_port,
+                const uip_ipaddr_t *receiver_addr,
+                uint16_t receiver_port,
+                const uint8_t *data,
+                uint16_t datalen)
+{
+  rtimer_clock_t start = RTIMER_NOW();
+  uip_ipaddr_t sender, receiver;
+  uip_ipaddr_copy(&sender, sender_addr);
+  uip_ipaddr_copy(&receiver, receiver_addr);
+  attest_stats_inc(ATTEST_STAT_RX);
+  udp_rx_process(c, &sender, sender_port, &receiver, receiver_port, data, datalen);
+  attest_stats_record(ATTEST_HIST_CALLBACK_TICKS, (rtimer_clock_t)(RTIMER_NOW() - start));
+}
+
 /*--------------------------------------------------------------------------------------------------
 ---------------------------------- Main process of the client node -----------------------------------
 --------------------------------------------------------------------------------------------------*/
 
 PROCESS_THREAD(udp_client_process, ev, data){
-  // Create the instance of the timer
-  static struct etimer periodic_timer;
-
   // Set the message length
   static char str[120];
 
@@ -216,6 +282,14 @@ PROCESS_THREAD(udp_client_process, ev, data){
   // Start the main process
   PROCESS_BEGIN();
 
+  // Initialize the live attestation servers
+  attest_shard_init();
+
+#if MAC_CONF_WITH_TSCH
+  // Start TSCH, the mote scans the channels and joins the network of the RPL root
+  NETSTACK_MAC.on();
+#endif
+
   // Produce the PUF key
   if(initialSetupPUF){
     // The key is used using urandom pseudorandom unix machine and it is saved in the variable
@@ -236,14 +310,30 @@ PROCESS_THREAD(udp_client_process, ev, data){
   // Initialize UDP connection
   simple_udp_register(&udp_conn, UDP_CLIENT_PORT, NULL, UDP_SERVER_PORT, udp_rx_callback);
 
+  // Start the hourly report and the quarantine of the rejected motes
+  attest_report_init();
+  attest_quarantine_init();
+  attest_stats_init(ATTEST_STATS_ROLE_CLIENT);
+
   // Set the timer
   etimer_set(&periodic_timer, random_rand() % SEND_INTERVAL);
   while(1) {
     // Wait until the timer expires
     PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&periodic_timer));
 
+    // A server that did not answer the previous message is counted as missed, after
+    // ATTEST_SHARD_CLIENT_MISSES of them the mote moves to the next owner
+    if(awaiting_reply) {
+      attest_stats_inc(ATTEST_STAT_MISSED);
+    }
+    if(awaiting_reply && attest_shard_missed(server_index)) {
+      LOG_INFO("The server %u is not answering, live servers mask: 0x%04x\n",
+               server_index + 1, attest_shard_live_mask());
+    }
+    awaiting_reply = false;
+
     if(NETSTACK_ROUTING.node_is_reachable() &&
-        NETSTACK_ROUTING.get_root_ipaddr(&dest_ipaddr)) {
+        attest_shard_get_server(&dest_ipaddr)) {
 
       // Print statistics every 10th TX
       if(tx_count % 10 == 0) {
@@ -257,10 +347,14 @@ PROCESS_THREAD(udp_client_process, ev, data){
       LOG_INFO_("\n");
 
       // Prepare the message for sending
-      snprintf(str, sizeof(str), "%s hello %" PRIu32 "", local_client_key, tx_count);
+      snprintf(str, sizeof(str), "%s hello %" PRIu32 "%s", local_client_key, tx_count,
+               attest_pending ? " attest" : "");
+      attest_pending = false;
 
       // Send the message
-      simple_udp_sendto(&udp_conn, str, strlen(str), &dest_ipaddr);
+      attest_stats_sendto(&udp_conn, str, strlen(str), &dest_ipaddr);
+      server_index = attest_shard_server_index(&dest_ipaddr);
+      awaiting_reply = WITH_SERVER_REPLY && ATTEST_CONF_REPLY_MODE != ATTEST_REPLY_NONE;
 
       // Increase the tx counter
       tx_count++;
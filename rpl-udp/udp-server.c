@@ -45,6 +45,19 @@
 //   Calculate their PUF and respond.
 // * Additionally, if the server receives a validation message, then it calculates his PUF Key and
 //   replies back.
+// * When more than one attestation server is configured (ATTEST_SERVER_COUNT), each server owns
+//   only the clients that hash to it (see attest-shard.h). The servers exchange heartbeats with the
+//   number of clients they own and their live mask, a client that belongs to another server is
+//   redirected with a "moved" message, and the clients of a failed server are taken over by the
+//   remaining servers.
+// * In the piggyback mode (ATTEST_CONF_PIGGYBACK) the validation request is added to the reply of
+//   the next hello of each mote instead of a separate message, and the mote answers with "attest"
+//   in its next hello. A mote that does not send a hello in time gets a separate request.
+// * The reply to a hello is built in the outgoing packet buffer without a temporary copy. With
+//   ATTEST_CONF_REPLY_MODE it is a full echo, a short "ack <seq>" or no reply (see attest-msg.h).
+// * Built with make ATTEST_TSCH=1 the server runs TSCH instead of CSMA, the attestation packets
+//   have their own Orchestra slotframe (see orchestra-attest.h).
+// * Every hour the server prints the number of packets and the radio time (see attest-report.h).
 
 /*--------------------------------------------------------------------------------------------------
 ------------------------------------- Imports of the libraries -------------------------------------
@@ -56,6 +69,17 @@
 #include "net/netstack.h"
 #include "net/ipv6/simple-udp.h"
 #include "net/ipv6/uip.h"
+#include "sys/node-id.h"
+#include "attest-shard.h"
+#include "attest-report.h"
+#include "attest-msg.h"
+#include "attest-registry.h"
+#include "attest-quarantine.h"
+#include "attest-stats.h"
+#include "sys/rtimer.h"
+#if MAC_CONF_WITH_TSCH
+#include "net/mac/tsch/tsch.h"
+#endif
 #include <stdint.h>
 #include <inttypes.h>
 #include "sys/log.h"
@@ -89,7 +113,7 @@ const bool server = true;
 --------------------------------------------------------------------------------------------------*/
 
 // Initialize the PUF key
-char local_server_key[20] = "initialkey";
+char local_server_key[ATTEST_KEY_SIZE] = "initialkey";
 
 // Initialize the parameters for the validation
 bool initialSetupPUF=true;
@@ -100,17 +124,15 @@ bool servervalidate = false;
 ---------------------------------- Initialize arrays for the nodes ---------------------------------
 --------------------------------------------------------------------------------------------------*/
 
-// Initialize the maximum nodes
-#define MAX_NODES 10
+// The remote keys, sender ports and IP arrays are kept by the registry (see attest-registry.h)
 
-// Initialize the remote keys array
-char remotekeys[MAX_NODES][20];
-
-// Initialize the sender port array
-uint16_t sender_ports[MAX_NODES];
-
-// Initialize the IP array
-uip_ipaddr_t sender_addrs[MAX_NODES];
+// Initialize the challenge state array and the time each challenge was issued. A challenge is
+// pending while it waits for a reply to carry it (piggyback mode), and sent until the mote answers
+#define CHALLENGE_NONE    0
+#define CHALLENGE_PENDING 1
+#define CHALLENGE_SENT    2
+uint8_t challenge_state[MAX_NODES];
+clock_time_t challenge_time[MAX_NODES];
 
 // Initialize the zero IPv6 address
 const uip_ipaddr_t uip_all_zeroes_addr;
@@ -122,82 +144,144 @@ const uip_ipaddr_t uip_all_zeroes_addr;
 // Create the static instance of the UDP connection
 static struct simple_udp_connection udp_conn;
 
+// Create the static instance of the UDP connection between the attestation servers
+#if ATTEST_SERVER_COUNT > 1
+static struct simple_udp_connection shard_conn;
+#endif
+
 // Create the UDP Server process and start it
 PROCESS(udp_server_process, name);
 AUTOSTART_PROCESSES(&udp_server_process);
 
+// Send the validation request to the mote stored in the cell i of the arrays
+static void
+send_challenge(int i)
+{
+  static char challenge[32];
+  LOG_INFO("Sending request to validate, to the node with IP: '");
+  LOG_INFO_6ADDR(&sender_addrs[i]);
+  LOG_INFO_("', Key: '%s'\n",remotekeys[i]);
+  snprintf(challenge, sizeof(challenge), "%s validate ", local_server_key);
+  attest_stats_sendto(&udp_conn, challenge, strlen(challenge), &sender_addrs[i]);
+  if (challenge_state[i] == CHALLENGE_NONE) {
+    challenge_time[i] = clock_time();
+  }
+  challenge_state[i] = CHALLENGE_SENT;
+  attest_stats_inc(ATTEST_STAT_CHALLENGES);
+}
+
 // Call back function. This function is used to process the received messages from the UDP client
 static void
-udp_rx_callback(struct simple_udp_connection *c,
-                const uip_ipaddr_t *sender_addr,
-                uint16_t sender_port,
-                const uip_ipaddr_t *receiver_addr,
-                uint16_t receiver_port,
-                const uint8_t *data,
-                uint16_t datalen)
+udp_rx_process(struct simple_udp_connection *c,
+               const uip_ipaddr_t *sender_addr,
+               uint16_t sender_port,
+               const uip_ipaddr_t *receiver_addr,
+               uint16_t receiver_port,
+               const uint8_t *data,
+               uint16_t datalen)
 {
-  // The following code block gets the key from the message
+  // The following code block gets the key and the items from the message. The parser checks the
+  // lengths and works on the received data without copying it
+  struct attest_msg msg;
+  int result = attest_msg_parse(data, datalen, &msg);
+  if (result != ATTEST_MSG_OK) {
+    attest_stats_inc(ATTEST_STAT_RX_DROPPED);
+    LOG_INFO("Dropping a message (%s) from IP: '", attest_msg_error(result));
+    LOG_INFO_6ADDR(sender_addr);
+    LOG_INFO_("'\n");
+    return;
+  }
+  char remotekey[ATTEST_KEY_SIZE];
+  attest_msg_copy_key(&msg, remotekey);
+
+#if ATTEST_SERVER_COUNT > 1
+  // The following code block redirects the motes that are owned by another attestation server. The
+  // reply carries the live servers mask so that the mote can find its owner.
   static char str[120];
-  char data_copy[121];
-  memcpy(data_copy, data, datalen);
-  data_copy[121] = '\0';
-  char *token = strtok(data_copy, " ");
-  char remotekey[20];
-  if (token != NULL) {
-    strcpy(remotekey, token);
+  uint8_t owner = attest_shard_owner(sender_addr);
+  if(owner != attest_shard_self()) {
+    LOG_INFO("The mote with Port:'%u' IP: '", sender_port);
+    LOG_INFO_6ADDR(sender_addr);
+    LOG_INFO_("' is owned by the server %u, redirecting it.\n", owner + 1);
+    attest_stats_inc(ATTEST_STAT_REDIRECTS);
+    snprintf(str, sizeof(str), "%s moved %u", local_server_key, attest_shard_live_mask());
+    attest_stats_sendto(&udp_conn, str, strlen(str), sender_addr);
+    return;
   }
+#endif /* ATTEST_SERVER_COUNT > 1 */
 
   // The following code block performs the validation of the KEY received and the IP of the sender
   int i;
-  for (i = 0; i < MAX_NODES; i++) {
-    // Get the IP of the sender
-    uip_ipaddr_t* ip_ptr = &sender_addrs[i];
-    // Perform a validation if the sender IP and port already exist in the aforementioned arrays
-    if (sender_ports[i] == sender_port && memcmp(ip_ptr, sender_addr, sizeof(uip_ip6addr_t)) == 0){
-      // Verify if the remote key is validated or not
-      if (strcmp(remotekeys[i], remotekey) == 0){
-        // Key is validated
-        LOG_INFO("The key '%s' of the node with Port:'%u' ",remotekey,sender_port);
-        LOG_INFO_("IP: '");
-        LOG_INFO_6ADDR(sender_addr);
-        LOG_INFO_("' is verified.\n");
-        break;
-      }
-      else{
-        // Key is not validated
-        LOG_INFO("The key '%s' of the node with Port:'%u' ",remotekey,sender_port);
-        LOG_INFO_("IP: '");
-        LOG_INFO_6ADDR(sender_addr);
-        LOG_INFO_("' is not verified closing the communication with this node.\n");
-        // Drop the connection with no further processing
-        return;
-        break;
-      }
-  }
-  else{
-    // In this case the node has sent a message for the first time, saving in the arrays the IP, port
-    // and the key of the node. The values are stored in an empty cell in the arrays
-    if (sender_ports[i] == 0 && uip_ipaddr_cmp(&sender_addrs[i], &uip_all_zeroes_addr)) {
-      strcpy(remotekeys[i], token);
-      sender_ports[i] = sender_port;
-      uip_ipaddr_copy(&sender_addrs[i], sender_addr);
-      LOG_INFO("The mote with:key '%s' ,Port:'%u' ",remotekey,sender_port);
-      LOG_INFO_(",IP: '");
+  switch (attest_registry_check(sender_addr, sender_port, &msg, &i)) {
+  case ATTEST_REGISTRY_VERIFIED:
+    // Key is validated
+    attest_stats_inc(ATTEST_STAT_VERIFIED);
+    LOG_INFO("The key '%s' of the node with Port:'%u' ",remotekey,sender_port);
+    LOG_INFO_("IP: '");
+    LOG_INFO_6ADDR(sender_addr);
+    LOG_INFO_("' is verified.\n");
+    break;
+  case ATTEST_REGISTRY_REJECTED:
+    // Key is not validated
+    attest_stats_inc(ATTEST_STAT_REJECTED);
+    LOG_INFO("The key '%s' of the node with Port:'%u' ",remotekey,sender_port);
+    LOG_INFO_("IP: '");
+    LOG_INFO_6ADDR(sender_addr);
+    LOG_INFO_("' is not verified closing the communication with this node.\n");
+    // Quarantine the mote, its following packets are dropped by every mote before any parsing
+    int quarantine = attest_quarantine_add(sender_addr);
+    if (quarantine == ATTEST_QUARANTINE_ADDED) {
+      attest_stats_inc(ATTEST_STAT_QUARANTINED);
+      LOG_INFO("The mote with IP: '");
       LOG_INFO_6ADDR(sender_addr);
-      LOG_INFO_("' was added to the list of known mote.\n");
-      break;
-     }
+      LOG_INFO_("' is quarantined, %u motes in quarantine.\n", attest_quarantine_count());
     }
+    else if (quarantine == ATTEST_QUARANTINE_FULL) {
+      attest_stats_inc(ATTEST_STAT_QUARANTINE_FULL);
+    }
+    // Drop the connection with no further processing, the mote is forgotten even when it could not
+    // be quarantined
+    attest_registry_remove(i);
+    challenge_state[i] = CHALLENGE_NONE;
+    return;
+  case ATTEST_REGISTRY_ENROLLED:
+    // In this case the node has sent a message for the first time, the IP, port and the key of the
+    // node are stored in an empty cell in the arrays
+    attest_stats_inc(ATTEST_STAT_ENROLLED);
+    challenge_state[i] = CHALLENGE_NONE;
+    LOG_INFO("The mote with:key '%s' ,Port:'%u' ",remotekey,sender_port);
+    LOG_INFO_(",IP: '");
+    LOG_INFO_6ADDR(sender_addr);
+    LOG_INFO_("' was added to the list of known mote.\n");
+    break;
+  case ATTEST_REGISTRY_FULL:
+    // The arrays are full, the message is processed without keeping the mote
+    attest_stats_inc(ATTEST_STAT_REGISTRY_FULL);
+    LOG_INFO("The list of known motes is full, the mote with Port:'%u' is not stored.\n",
+             sender_port);
+    break;
   }
 
-  // The following code block gets the message, and validates if there is a validation message send
-  char *taken = strtok(NULL, " ");
-  LOG_INFO("Received message '%s'\n",taken);
-  if (taken != NULL && strcmp(taken, "validate") == 0) {
+  // The following code block gets the message, and validates if there is a validation message send.
+  // A message can carry more than one item, e.g. a hello followed by the "attest" response
+  LOG_INFO("Received message '%.*s'\n", msg.first_len, msg.first != NULL ? msg.first : "");
+  if (msg.items & ATTEST_ITEM_VALIDATE) {
     LOG_INFO("Received validation message\n");
     servervalidate=true;
   }
 
+  // The following code block completes the challenge of the mote. The response is either a separate
+  // "attest" message or it is piggybacked on a hello, the key was already verified above
+  if ((msg.items & ATTEST_ITEM_ATTEST) && i < MAX_NODES && challenge_state[i] != CHALLENGE_NONE) {
+    unsigned long attest_ms = (clock_time() - challenge_time[i]) * 1000 / CLOCK_SECOND;
+    attest_stats_inc(ATTEST_STAT_COMPLETED);
+    attest_stats_record(ATTEST_HIST_ATTEST_MS, attest_ms);
+    LOG_INFO("The mote with key '%s' IP: '", remotekey);
+    LOG_INFO_6ADDR(sender_addr);
+    LOG_INFO_("' completed the attestation in %lu ms.\n", attest_ms);
+    challenge_state[i] = CHALLENGE_NONE;
+  }
+
   // Validation code block, in case the server receives a validate message this node will keep its
   // original PUF key. Since the code is working with a random generator instead of a real PUF
   // We need to keep the key the same.
@@ -214,37 +298,203 @@ udp_rx_callback(struct simple_udp_connection *c,
 
 #if WITH_SERVER_REPLY
 
+  // A separate "attest" response needs no reply, all the other messages get a reply depending on
+  // ATTEST_CONF_REPLY_MODE. The reply is sent first because it is built in the packet buffer, over
+  // the received data
+  if (msg.type != ATTEST_MSG_ATTEST) {
+    // In the piggyback mode a pending validation request is added to the reply
+    bool challenge = false;
+#if ATTEST_CONF_PIGGYBACK
+    if (i < MAX_NODES && challenge_state[i] == CHALLENGE_PENDING) {
+      LOG_INFO("Adding the request to validate to the reply, Key: '%s'\n", remotekeys[i]);
+      challenge = true;
+      challenge_state[i] = CHALLENGE_SENT;
+      attest_stats_inc(ATTEST_STAT_CHALLENGES);
+    }
+#endif /* ATTEST_CONF_PIGGYBACK */
+
+    // The reply is written where uIP sends it from, after the IPv6 and UDP headers, so that the
+    // copy of uip_udp_packet_send has the same source and destination. The body is copied there
+    // from the buffer of simple-udp, which holds the received payload
+    uint8_t *reply = &uip_buf[UIP_IPUDPH_LEN];
+    uint16_t reply_len = attest_msg_build_reply(reply, UIP_BUFSIZE - UIP_IPUDPH_LEN,
+                                                local_server_key, &msg, ATTEST_CONF_REPLY_MODE,
+                                                challenge);
+    if (reply_len > 0) {
+      LOG_INFO("Sending response from the '%s' with key '%s'.\n",name,local_server_key);
+      attest_stats_sendto(&udp_conn, reply, reply_len, sender_addr);
+    }
+  }
+
   // Send validation message
   if(validate) {
     int i;
     for (i = 0; i < MAX_NODES; i++) {
-      uip_ipaddr_t* valid_ip_pt = &sender_addrs[i];
-      char valid_remotekey[20];
-      strcpy(valid_remotekey,remotekeys[i]);
       // Check if both sender_addrs[i] and remotekeys[i] are populated
-      if (valid_ip_pt && valid_remotekey[0] != '\0') {
-        LOG_INFO("Sending request to validate, to the node with IP: '");
-        LOG_INFO_6ADDR(valid_ip_pt);
-        LOG_INFO_("', Key: '%s'\n",valid_remotekey);
-        snprintf(str, sizeof(str), "%s validate ", local_server_key);
-        simple_udp_sendto(&udp_conn, str, strlen(str), valid_ip_pt);
+      if (remotekeys[i][0] != '\0') {
+        send_challenge(i);
       }
     }
     validate = false;
   }
 
-  // send back the same string to the client as an echo reply
-  LOG_INFO("Sending response from the '%s' with key '%s'.\n",name,local_server_key);
+#endif /* WITH_SERVER_REPLY */
+}
+
+// Call back function. This function counts the received messages and measures their processing in
+// rtimer ticks for the statistics
+static void
+udp_rx_callback(struct simple_udp_connection *c,
+                const uip_ipaddr_t *sender_addr,
+                uint16_t sender_port,
+                const uip_ipaddr_t *receiver_addr,
+                uint16_t receiver_port,
+                const uint8_t *data,
+                uint16_t datalen)
+{
+  rtimer_clock_t start = RTIMER_NOW();
+  attest_stats_inc(ATTEST_STAT_RX);
+  udp_rx_process(c, sender_addr, sender_port, receiver_addr, receiver_port, data, datalen);
+  attest_stats_record(ATTEST_HIST_CALLBACK_TICKS, (rtimer_clock_t)(RTIMER_NOW() - start));
+}
 
-  //Preparing the reply with the server key:
-  char new_data[121];
-  char new_data_copy[121];
-  memcpy(new_data_copy, data, datalen);
-  sprintf(new_data, "%s %s", local_server_key, new_data_copy + strlen(remotekey) + 1);
-  size_t new_data_len = strlen(new_data);
-  simple_udp_sendto(&udp_conn, new_data, new_data_len, sender_addr);
+#if ATTEST_SERVER_COUNT > 1
+/*--------------------------------------------------------------------------------------------------
+----------------------------------- Shard ownership exchange ---------------------------------------
+--------------------------------------------------------------------------------------------------*/
 
-#endif /* WITH_SERVER_REPLY */
+// Remove from the arrays the motes that are no longer owned by this server. This happens when a
+// server that was down comes back and takes over its clients again.
+static void
+shard_release(void)
+{
+  int i;
+  for (i = 0; i < MAX_NODES; i++) {
+    if (sender_ports[i] != 0 && attest_shard_owner(&sender_addrs[i]) != attest_shard_self()) {
+      LOG_INFO("The mote with key '%s' IP: '", remotekeys[i]);
+      LOG_INFO_6ADDR(&sender_addrs[i]);
+      LOG_INFO_("' is handed over to the server %u.\n", attest_shard_owner(&sender_addrs[i]) + 1);
+      attest_registry_remove(i);
+      challenge_state[i] = CHALLENGE_NONE;
+    }
+  }
+}
+
+// Send the heartbeat with the shard ownership of this server to the other servers. The message is
+// "<key> shard <server index> <owned motes> <live mask>"
+static void
+shard_send_heartbeat(void)
+{
+  static char heartbeat[64];
+  uip_ipaddr_t peer_addr;
+  uint8_t i;
+
+  snprintf(heartbeat, sizeof(heartbeat), "%s shard %u %u %u", local_server_key,
+           attest_shard_self(), (unsigned)attest_registry_count(), attest_shard_live_mask());
+  for (i = 0; i < ATTEST_SERVER_COUNT; i++) {
+    if (i != attest_shard_self()) {
+      attest_shard_server_addr(i, &peer_addr);
+      simple_udp_sendto(&shard_conn, heartbeat, strlen(heartbeat), &peer_addr);
+    }
+  }
+}
+
+// Call back function. This function is used to process the heartbeats of the other servers
+static void
+shard_rx_callback(struct simple_udp_connection *c,
+                  const uip_ipaddr_t *sender_addr,
+                  uint16_t sender_port,
+                  const uip_ipaddr_t *receiver_addr,
+                  uint16_t receiver_port,
+                  const uint8_t *data,
+                  uint16_t datalen)
+{
+  char heartbeat[64];
+  char peer_key[20];
+  unsigned index, owned, mask;
+  uint16_t removed;
+  uint8_t i;
+
+  if (datalen >= sizeof(heartbeat)) {
+    return;
+  }
+  memcpy(heartbeat, data, datalen);
+  heartbeat[datalen] = '\0';
+  if (sscanf(heartbeat, "%19s shard %u %u %u", peer_key, &index, &owned, &mask) != 4 ||
+      index != attest_shard_server_index(sender_addr)) {
+    LOG_INFO("Dropping an invalid shard message from IP: '");
+    LOG_INFO_6ADDR(sender_addr);
+    LOG_INFO_("'\n");
+    return;
+  }
+
+  LOG_INFO("The server %u with key '%s' owns %u motes.\n", index + 1, peer_key, owned);
+  if (attest_shard_heard(index)) {
+    LOG_INFO("The server %u is up again.\n", index + 1);
+    shard_release();
+  }
+
+  // The servers that the peer lost are removed here too, so both servers own the same motes
+  removed = attest_shard_reconcile((uint16_t)mask);
+  for (i = 0; i < ATTEST_SERVER_COUNT; i++) {
+    if (removed & (1u << i)) {
+      LOG_INFO("The server %u is down for the server %u, its motes are reassigned.\n", i + 1,
+               index + 1);
+    }
+  }
+}
+#endif /* ATTEST_SERVER_COUNT > 1 */
+
+/*--------------------------------------------------------------------------------------------------
+------------------------------------------ Challenges ----------------------------------------------
+--------------------------------------------------------------------------------------------------*/
+
+// Issue a challenge to every known mote. In the piggyback mode the challenges wait for the next
+// hello of each mote, otherwise the validation messages are sent with the next received message
+static void
+issue_challenges(void)
+{
+  LOG_INFO("Starting an attestation round for %u motes.\n", (unsigned)attest_registry_count());
+#if ATTEST_CONF_PIGGYBACK
+  int i;
+  for (i = 0; i < MAX_NODES; i++) {
+    if (remotekeys[i][0] != '\0' && challenge_state[i] == CHALLENGE_NONE) {
+      challenge_state[i] = CHALLENGE_PENDING;
+      challenge_time[i] = clock_time();
+    }
+  }
+#else
+  validate=true;
+#endif
+}
+
+// Check the deadlines of the challenges. A pending challenge that was not carried by a reply in
+// half of the deadline is sent as a separate message, and a mote that does not answer in twice the
+// deadline is reported
+static void
+check_challenges(void)
+{
+  clock_time_t now = clock_time();
+  uint16_t outstanding = 0;
+  int i;
+  for (i = 0; i < MAX_NODES; i++) {
+    if (challenge_state[i] == CHALLENGE_PENDING &&
+        now - challenge_time[i] > ATTEST_CONF_CHALLENGE_DEADLINE / 2) {
+      send_challenge(i);
+    }
+    else if (challenge_state[i] == CHALLENGE_SENT &&
+             now - challenge_time[i] > 2 * ATTEST_CONF_CHALLENGE_DEADLINE) {
+      LOG_INFO("The mote with key '%s' IP: '", remotekeys[i]);
+      LOG_INFO_6ADDR(&sender_addrs[i]);
+      LOG_INFO_("' did not answer the request to validate in time.\n");
+      attest_stats_inc(ATTEST_STAT_EXPIRED);
+      challenge_state[i] = CHALLENGE_NONE;
+    }
+    if (challenge_state[i] != CHALLENGE_NONE) {
+      outstanding++;
+    }
+  }
+  attest_stats_set_gauge(ATTEST_GAUGE_CHALLENGES, outstanding);
 }
 
 /*--------------------------------------------------------------------------------------------------
@@ -253,12 +503,27 @@ udp_rx_callback(struct simple_udp_connection *c,
 PROCESS_THREAD(udp_server_process, ev, data){
   // Create the instance of the timer
   static struct etimer et;
+  static struct etimer challenge_timer;
+#if ATTEST_SERVER_COUNT > 1
+  static struct etimer shard_timer;
+#endif
 
   // Start the main process
   PROCESS_BEGIN();
 
-  // Initialize DAG root
-  NETSTACK_ROUTING.root_start();
+  // Initialize DAG root, when there are several attestation servers only the first one is the root
+  attest_shard_init();
+  if(ATTEST_SERVER_COUNT == 1 || attest_shard_self() == 0) {
+    NETSTACK_ROUTING.root_start();
+#if MAC_CONF_WITH_TSCH
+    tsch_set_coordinator(1);
+#endif
+  }
+
+#if MAC_CONF_WITH_TSCH
+  // Start TSCH, the RPL root is the TSCH coordinator and the other motes join its network
+  NETSTACK_MAC.on();
+#endif
 
   // Print the functionality of the process
   LOG_INFO("The mode of the node is set to: '%s'\n", name);
@@ -283,13 +548,47 @@ PROCESS_THREAD(udp_server_process, ev, data){
   // Initialize UDP connection
   simple_udp_register(&udp_conn, UDP_SERVER_PORT, NULL, UDP_CLIENT_PORT, udp_rx_callback);
 
+  // Start the hourly report, the quarantine of the rejected motes and the timer of the challenge
+  // deadlines
+  attest_report_init();
+  attest_quarantine_init();
+  attest_stats_init(ATTEST_STATS_ROLE_SERVER);
+  etimer_set(&challenge_timer, ATTEST_CONF_CHALLENGE_DEADLINE / 10);
+
+#if ATTEST_SERVER_COUNT > 1
+  // Initialize the UDP connection with the other servers and the heartbeat timer
+  simple_udp_register(&shard_conn, UDP_SHARD_PORT, NULL, UDP_SHARD_PORT, shard_rx_callback);
+  LOG_INFO("Attestation server %u of %u\n", attest_shard_self() + 1, ATTEST_SERVER_COUNT);
+  etimer_set(&shard_timer, ATTEST_SHARD_HEARTBEAT);
+#endif
+
   // At a random time frame to send a validation message to the nodes
   etimer_set(&et, random_rand() % CLOCK_SECOND * 320);
   while(1) {
-    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
-      validate=true;
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER);
+    if(data == &et) {
+      issue_challenges();
       etimer_set(&et, random_rand() % CLOCK_SECOND * 180);
     }
+    else if(data == &challenge_timer) {
+      check_challenges();
+      etimer_reset(&challenge_timer);
+    }
+#if ATTEST_SERVER_COUNT > 1
+    else if(data == &shard_timer) {
+      // Remove the servers that were not heard, their motes are taken over by the live servers
+      uint16_t removed = attest_shard_expire();
+      uint8_t i;
+      for(i = 0; i < ATTEST_SERVER_COUNT; i++) {
+        if(removed & (1u << i)) {
+          LOG_INFO("The server %u is down, its motes are reassigned.\n", i + 1);
+        }
+      }
+      shard_send_heartbeat();
+      etimer_set(&shard_timer, ATTEST_SHARD_HEARTBEAT);
+    }
+#endif
+  }
 
 
 